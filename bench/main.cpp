@@ -0,0 +1,742 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "tinyui.h"
+#include "widgets.h"
+#include "command_queue.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "layout.h"
+#include "profiler.h"
+#include "logger.h"
+#include "backends/null_renderer.h"
+#include "backends/sdl2_event_recorder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tinyui;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief A measured value of a benchmark.
+    struct BenchResult {
+        std::string mName;      ///< The name of the benchmark.
+        double      mValue;     ///< The measured value.
+        const char *mUnit;      ///< The unit of the value.
+    };
+
+    std::vector<BenchResult> Results;
+
+    /// @brief Will print a measured value and store it for the machine-readable report.
+    /// @param[in] name  The name of the value.
+    /// @param[in] value The value.
+    /// @param[in] unit  The unit of the value.
+    void report(const char *name, double value, const char *unit) {
+        printf("%-32s %12.3f %s\n", name, value, unit);
+        Results.push_back({ name, value, unit });
+    }
+
+    /// @brief Will write all reported values as JSON, the names are stable between releases.
+    /// @param[in] filename The name of the report file.
+    /// @return true if the report was written.
+    bool writeJsonReport(const char *filename) {
+        FILE *file = fopen(filename, "w");
+        if (file == nullptr) {
+            return false;
+        }
+
+        const Version &version = TinyUi::getContext().mVersion;
+        fprintf(file, "{\n  \"version\": \"%u.%u.%u\",\n  \"results\": [", version.major, version.minor, version.patch);
+        for (size_t i = 0; i < Results.size(); ++i) {
+            const BenchResult &result = Results[i];
+            fprintf(file, "%s\n    { \"name\": \"%s\", \"value\": %.3f, \"unit\": \"%s\" }",
+                i == 0 ? "" : ",", result.mName.c_str(), result.mValue, result.mUnit);
+        }
+        fprintf(file, "\n  ]\n}\n");
+        const bool ok = ferror(file) == 0;
+        fclose(file);
+
+        return ok;
+    }
+
+    /// @brief Will run a benchmark and print the time per operation.
+    /// @param[in] name          The name of the benchmark.
+    /// @param[in] numOperations The number of operations done by one run of the function.
+    /// @param[in] numRuns       The number of runs.
+    /// @param[in] func          The function to measure.
+    /// @return The time per operation in nanoseconds.
+    double runBenchmark(const char *name, size_t numOperations, size_t numRuns, const std::function<void()> &func) {
+        // Warm up the caches before measuring
+        func();
+
+        const auto start = Clock::now();
+        for (size_t i = 0; i < numRuns; ++i) {
+            func();
+        }
+        const auto end = Clock::now();
+
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        const double nsPerOp = ns / static_cast<double>(numOperations * numRuns);
+        report(name, nsPerOp, "ns/op");
+
+        return nsPerOp;
+    }
+
+    void benchDrawDispatch(Context &ctx) {
+        constexpr size_t NumDraws = 1000000;
+        const Color4 color{ 255, 255, 255, 255 };
+
+        // Only the cost of the virtual call is measured, so the null backend does not draw anything
+        NullRenderBackend backend;
+
+        // The volatile pointer prevents the compiler from resolving the virtual call
+        RenderBackendI *volatile iface = &backend;
+        const double direct = runBenchmark("draw_rect_direct", NumDraws, 10, [&]() {
+            for (size_t i = 0; i < NumDraws; ++i) {
+                backend.NullRenderBackend::drawRect(ctx, 0, 0, 10, 10, true, color);
+            }
+        });
+        const double dispatched = runBenchmark("draw_rect_virtual", NumDraws, 10, [&]() {
+            for (size_t i = 0; i < NumDraws; ++i) {
+                iface->drawRect(ctx, 0, 0, 10, 10, true, color);
+            }
+        });
+        report("draw_dispatch_overhead", dispatched - direct, "ns/op");
+    }
+
+    /// @brief Will return the draw calls of the last rendered frame.
+    /// @return The number of draw calls, the copy of the retained frame included.
+    double getLastDrawCalls() {
+        FrameStats stats;
+        return TinyUi::getFrameStats(stats) == ResultOk ? static_cast<double>(stats.mNumDrawCalls) : 0.0;
+    }
+
+    void benchRenderWidgets() {
+        constexpr size_t NumWidgets = 10000;
+        WidgetHandle panel = Widgets::panel(WidgetHandle::getRootHandle(), "Benchmark", Rect(0, 0, 1000, 1000), nullptr);
+        for (size_t i = 0; i < NumWidgets; ++i) {
+            const int32_t x = static_cast<int32_t>(i % 100) * 10;
+            const int32_t y = static_cast<int32_t>(i / 100) * 10;
+            Widgets::box(panel, Rect(x, y, 8, 8), (i % 2) == 0);
+        }
+
+        runBenchmark("render_widgets_10k", NumWidgets, 100, []() {
+            TinyUi::invalidate();
+            TinyUi::render();
+        });
+        report("render_widgets_10k_draw_calls", getLastDrawCalls(), "count");
+        Widgets::clear();
+    }
+
+    void buildWidgets(size_t numPanels, size_t numChildren, std::vector<WidgetHandle> &handles) {
+        for (size_t i = 0; i < numPanels; ++i) {
+            // The panels are tiled like the cells of a dashboard
+            const int32_t px = static_cast<int32_t>(i % 40) * 100;
+            const int32_t py = static_cast<int32_t>(i / 40) * 100;
+            const WidgetHandle panel = Widgets::panel(WidgetHandle::getRootHandle(), "Panel", Rect(px, py, 100, 100), nullptr);
+            handles.push_back(panel);
+            for (size_t j = 0; j < numChildren; ++j) {
+                const int32_t x = px + static_cast<int32_t>(j % 10) * 10;
+                const int32_t y = py + static_cast<int32_t>(j / 10) * 10;
+                handles.push_back(Widgets::box(panel, Rect(x, y, 8, 8), true));
+            }
+        }
+    }
+
+    void benchBuildWidgets() {
+        // The children are added to the panels one after the other, so every parent lookup
+        // needs to find a panel behind all widgets created before.
+        constexpr size_t NumPanels = 1000;
+        constexpr size_t NumChildren = 99;
+        constexpr size_t NumWidgets = NumPanels * (NumChildren + 1);
+        std::vector<WidgetHandle> handles;
+        handles.reserve(NumWidgets);
+        runBenchmark("build_widgets_100k", NumWidgets, 5, [&]() {
+            handles.clear();
+            buildWidgets(NumPanels, NumChildren, handles);
+            Widgets::clear();
+        });
+
+    }
+
+    int64_t sumEnabledArea(const Widget *widget) {
+        if (!widget->isEnabled()) {
+            return 0;
+        }
+
+        int64_t area = static_cast<int64_t>(widget->mRect.width) * widget->mRect.height;
+        for (const Widget *child : widget->mChildren) {
+            area += sumEnabledArea(child);
+        }
+
+        return area;
+    }
+
+    int64_t sumEnabledArea(const WidgetTree &tree) {
+        int64_t area = 0;
+        const size_t numWidgets = tree.size();
+        for (size_t i = 0; i < numWidgets;) {
+            if ((tree.mFlags[i] & WidgetTree::EnabledFlag) == 0) {
+                i = tree.mSubtreeEnd[i];
+                continue;
+            }
+            area += static_cast<int64_t>(tree.mRects[i].width) * tree.mRects[i].height;
+            ++i;
+        }
+
+        return area;
+    }
+
+    void benchTraversal() {
+        constexpr size_t NumPanels = 1000;
+        constexpr size_t NumChildren = 99;
+        constexpr size_t NumWidgets = NumPanels * (NumChildren + 1);
+        std::vector<WidgetHandle> handles;
+        handles.reserve(NumWidgets);
+        buildWidgets(NumPanels, NumChildren, handles);
+
+        const auto &ctx = TinyUi::getContext();
+        const WidgetTree *tree = Widgets::getWidgetTree();
+        int64_t treeArea = 0;
+        int64_t soaArea = 0;
+        runBenchmark("traverse_pointer_tree_100k", NumWidgets, 20, [&]() {
+            treeArea = sumEnabledArea(ctx.mRoot);
+        });
+        runBenchmark("traverse_soa_100k", NumWidgets, 20, [&]() {
+            soaArea = sumEnabledArea(*tree);
+        });
+        if (treeArea != soaArea) {
+            printf("Traversal results differ.\n");
+        }
+
+        constexpr size_t NumHits = 1000;
+        runBenchmark("hit_test_pointer_tree_100k", NumHits, 10, [&]() {
+            for (size_t i = 0; i < NumHits; ++i) {
+                Widget *found = nullptr;
+                Widgets::findSelectedWidget(static_cast<int>(i * 37 % 4000), static_cast<int>(i * 53 % 2500), ctx.mRoot, &found);
+            }
+        });
+        runBenchmark("hit_test_grid_100k", NumHits, 10, [&]() {
+            for (size_t i = 0; i < NumHits; ++i) {
+                tree->findAt(static_cast<int32_t>(i * 37 % 4000), static_cast<int32_t>(i * 53 % 2500));
+            }
+        });
+        runBenchmark("mouse_move_100k", NumHits, 10, [&]() {
+            for (size_t i = 0; i < NumHits; ++i) {
+                Widgets::onMouseMove(static_cast<int>(i * 37 % 4000), static_cast<int>(i * 53 % 2500),
+                    Events::MouseMoveEvent, MouseState::Invalid);
+            }
+        });
+        for (size_t i = 0; i < NumHits; ++i) {
+            const int32_t x = static_cast<int32_t>(i * 37 % 4000);
+            const int32_t y = static_cast<int32_t>(i * 53 % 2500);
+            Widget *found = nullptr;
+            Widgets::findSelectedWidget(x, y, ctx.mRoot, &found);
+            const int32_t index = tree->findAt(x, y);
+            if (found != (index == -1 ? nullptr : tree->mWidgets[index])) {
+                printf("Hit test results differ at %d, %d.\n", x, y);
+                break;
+            }
+        }
+        Widgets::clear();
+    }
+
+    void benchCommandQueue() {
+        constexpr size_t NumThreads = 4;
+        constexpr size_t NumCommands = 100000;
+        const WidgetHandle panel = Widgets::panel(WidgetHandle::getRootHandle(), "Panel", Rect(0, 0, 100, 100), nullptr);
+        const WidgetHandle box = Widgets::box(panel, Rect(10, 10, 10, 10), true);
+
+        runBenchmark("post_commands_4_threads", NumThreads * NumCommands, 1, [&]() {
+            std::atomic<size_t> numDone{0};
+            std::vector<std::thread> producers;
+            for (size_t t = 0; t < NumThreads; ++t) {
+                producers.emplace_back([&]() {
+                    for (size_t i = 0; i < NumCommands; ++i) {
+                        TinyUi::postCommand(WidgetCommand::setEnableState(box, (i % 2) == 0));
+                    }
+                    numDone.fetch_add(1);
+                });
+            }
+
+            // The ui thread drains the queue while the producers are running
+            while (numDone.load() < NumThreads) {
+                TinyUi::run();
+            }
+            TinyUi::run();
+            for (std::thread &producer : producers) {
+                producer.join();
+            }
+        });
+        Widgets::clear();
+    }
+
+    void benchEventBus() {
+        constexpr size_t NumListeners = 8;
+        constexpr size_t NumEvents = 1000;
+        EventBus bus;
+        size_t numCalls = 0;
+        auto onEvent = [](const Event &, void *instance) {
+            ++*static_cast<size_t*>(instance);
+        };
+        for (size_t i = 0; i < NumListeners; ++i) {
+            bus.subscribe(Events::MouseMoveEvent, onEvent, &numCalls);
+        }
+
+        runBenchmark("event_bus_post_dispatch", NumEvents, 1000, [&]() {
+            Event event;
+            event.mId = Events::MouseMoveEvent;
+            for (size_t i = 0; i < NumEvents; ++i) {
+                event.mX = static_cast<int32_t>(i);
+                bus.post(event);
+            }
+            bus.dispatch();
+        });
+        if (numCalls == 0) {
+            printf("event bus did not call the listeners\n");
+        }
+    }
+
+    void benchTimerWheel() {
+        constexpr size_t NumTimers = 1000;
+        constexpr size_t NumFrames = 1000;
+        TimerWheel timers;
+        size_t numCalls = 0;
+        auto onTimer = [](TimerId, void *instance) {
+            ++*static_cast<size_t*>(instance);
+        };
+        uint32_t now = 0;
+        timers.advance(now);
+        for (size_t i = 0; i < NumTimers; ++i) {
+            const auto period = static_cast<uint32_t>(100 + (i * 7) % 900);
+            timers.add(now, period, period, onTimer, &numCalls);
+        }
+
+        // One frame per ms, most frames have no due timers
+        runBenchmark("timer_wheel_frame_1k_timers", NumFrames, 100, [&]() {
+            for (size_t i = 0; i < NumFrames; ++i) {
+                timers.advance(++now);
+            }
+        });
+        if (numCalls == 0) {
+            printf("timer wheel did not fire\n");
+        }
+    }
+
+    void benchLayout(Context &ctx) {
+        constexpr int32_t NumRows = 100;
+        constexpr int32_t NumColumns = 199;
+        const WidgetHandle screen = Widgets::panel(WidgetHandle::getRootHandle(), "Screen", Rect(0, 0, 1024, 768), nullptr);
+        Layout::setContainer(screen, LayoutDirection::Vertical, 1, 2);
+        Layout::setItem(screen, 0, 0, 1);
+        WidgetHandle lastBox;
+        for (int32_t row = 0; row < NumRows; ++row) {
+            const WidgetHandle line = Widgets::box(screen, Rect(0, 0, 10, 4), true);
+            Layout::setContainer(line, LayoutDirection::Horizontal, 1, 0);
+            Layout::setItem(line, 10, 4, 1);
+            for (int32_t column = 0; column < NumColumns; ++column) {
+                lastBox = Widgets::box(line, Rect(0, 0, 2, 2), true);
+                Layout::setItem(lastBox, 2, 2, 1);
+            }
+        }
+        Layout::update(ctx);
+
+        // Every resize moves and resizes all widgets
+        int32_t width = 1024;
+        runBenchmark("layout_resize_20k", 1, 100, [&]() {
+            width = width == 1024 ? 1280 : 1024;
+            Layout::setViewport(ctx, Rect(0, 0, width, 768));
+            Layout::update(ctx);
+        });
+
+        const Widget *box = Widgets::getWidgetById(lastBox);
+        if (box == nullptr || box->getScreenRect().bottom.x != width - 2) {
+            printf("layout mismatch\n");
+        }
+
+        // Changing one child only relayouts its row
+        int32_t size = 2;
+        runBenchmark("layout_change_one_child_20k", 1, 1000, [&]() {
+            size = size == 2 ? 3 : 2;
+            Widgets::setRect(lastBox, Rect(0, 0, size, size));
+            Layout::update(ctx);
+        });
+        Widgets::clear();
+    }
+
+    void benchMoveContainer() {
+        constexpr int32_t NumChildren = 1000;
+        const WidgetHandle panel = Widgets::panel(WidgetHandle::getRootHandle(), "Panel", Rect(0, 0, 400, 400), nullptr);
+        WidgetHandle lastBox;
+        for (int32_t i = 0; i < NumChildren; ++i) {
+            lastBox = Widgets::box(panel, Rect((i % 40) * 10, (i / 40) * 10, 8, 8), true);
+        }
+        Widgets::getWidgetTree();
+
+        // Dragging only updates the container, the children are relative to it
+        int32_t x = 0;
+        runBenchmark("move_container_1k_children", 1000, 100, [&]() {
+            for (int32_t i = 0; i < 1000; ++i) {
+                Widgets::setPosition(panel, ++x % 100, 0);
+            }
+        });
+
+        // The moved subtree is searched with the old grid entries shifted by the move
+        const Widget *box = Widgets::getWidgetById(lastBox);
+        runBenchmark("move_hit_test_1k_children", 1, 1000, [&]() {
+            Widgets::setPosition(panel, ++x % 100, 0);
+            const Rect r = box->getScreenRect();
+            Widgets::onMouseMove(r.top.x + 1, r.top.y + 1, Events::MouseMoveEvent, MouseState::Invalid);
+        });
+
+        const Rect r = box->getScreenRect();
+        const WidgetTree *tree = Widgets::getWidgetTree();
+        const int32_t index = tree->findAt(r.top.x + 1, r.top.y + 1);
+        if (index == -1 || tree->mWidgets[index] != box) {
+            printf("move mismatch\n");
+        }
+        Widgets::clear();
+    }
+
+    void benchCulling() {
+        // A dashboard of 4000x2500 pixels, most of it is outside of the 1024x768 surface
+        std::vector<WidgetHandle> handles;
+        buildWidgets(1000, 99, handles);
+        runBenchmark("render_canvas_100k", 1, 100, []() {
+            TinyUi::invalidate();
+            TinyUi::render();
+        });
+        report("render_canvas_100k_draw_calls", getLastDrawCalls(), "count");
+
+        // The overlay settles after one refresh, the following frames have nothing to draw
+        Widgets::statsOverlay(WidgetHandle::getRootHandle(), Rect(0, 0, 200, 80));
+        TinyUi::invalidate();
+        TinyUi::render();
+        FrameStats stats;
+        if (TinyUi::getFrameStats(stats) == ResultOk) {
+            report("render_canvas_100k_visited", static_cast<double>(stats.mNumWidgetsVisited), "count");
+            report("render_canvas_100k_culled", static_cast<double>(stats.mNumWidgetsCulled), "count");
+        }
+        size_t numFrames = 1;
+        for (auto &ctx = TinyUi::getContext(); ctx.mDirtyRegion.isDirty() && numFrames < 10; ++numFrames) {
+            TinyUi::render();
+        }
+        report("stats_overlay_frames", static_cast<double>(numFrames), "count");
+        Widgets::clear();
+    }
+
+    void benchProfiler() {
+        constexpr size_t NumScopes = 100000;
+        Profiler::reset();
+        runBenchmark("profile_scope", NumScopes, 10, []() {
+            for (size_t i = 0; i < NumScopes; ++i) {
+                ProfileScope scope("bench");
+            }
+        });
+
+        for (size_t i = 0; i < 100; ++i) {
+            Profiler::beginFrame();
+            ProfileScope scope("frame_work");
+        }
+        FrameTimeStats stats;
+        if (Profiler::getFrameTimeStats(stats) == ResultOk) {
+            report("profile_frame_p99", static_cast<double>(stats.mP99), "ns");
+        }
+        Profiler::reset();
+    }
+
+    void benchLogger(const Context &ctx) {
+        // The filtered messages must not cost any formatting
+        constexpr size_t NumMessages = 100000;
+        const LogSeverity severity = Logger::getMinSeverity();
+        Logger::setMinSeverity(LogSeverity::Error);
+        runBenchmark("log_format_filtered", NumMessages, 10, [&]() {
+            for (size_t i = 0; i < NumMessages; ++i) {
+                TINYUI_LOG(ctx, LogSeverity::Warn, "Cannot create texture: %s.", "bench");
+            }
+        });
+        Logger::setMinSeverity(severity);
+    }
+
+    /// @brief Will measure a widget factory, the time includes the release of the widgets.
+    /// @param[in] name     The name of the benchmark.
+    /// @param[in] inTree   true to create the widgets as items of a tree view.
+    /// @param[in] create   Creates one widget.
+    void benchFactory(const char *name, bool inTree, const std::function<void(WidgetHandle, const Rect&)> &create) {
+        constexpr size_t NumWidgets = 10000;
+        runBenchmark(name, NumWidgets, 5, [&]() {
+            // The panel creates the root container, the other factories need an existing one
+            WidgetHandle parent = Widgets::panel(WidgetHandle::getRootHandle(), "Panel", Rect(0, 0, 1000, 1000), nullptr);
+            if (inTree) {
+                parent = Widgets::treeView(parent, "Tree", Rect(0, 0, 1000, 10));
+            }
+            for (size_t i = 0; i < NumWidgets; ++i) {
+                const int32_t x = static_cast<int32_t>(i % 100) * 10;
+                const int32_t y = static_cast<int32_t>(i / 100) * 10;
+                create(parent, Rect(x, y, 8, 8));
+            }
+            Widgets::clear();
+        });
+    }
+
+    void benchFactories() {
+        benchFactory("create_box_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::box(parent, r, true);
+        });
+        benchFactory("create_panel_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::panel(parent, "Panel", r, nullptr);
+        });
+        benchFactory("create_container_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::rootContainer(parent, "Container", r);
+        });
+        benchFactory("create_label_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::label(parent, "Label", r, Alignment::Left);
+        });
+        benchFactory("create_input_text_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::inputText(parent, r, Alignment::Left, KeyInputType::Character, "Input");
+        });
+        benchFactory("create_text_button_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::textButton(parent, "Button", r, Alignment::Center, nullptr);
+        });
+        // The images are not loaded, only the widget is measured
+        benchFactory("create_image_button_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::imageButton(parent, nullptr, r, nullptr);
+        });
+        benchFactory("create_image_box_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::imageBox(parent, nullptr, r, true);
+        });
+        benchFactory("create_progress_bar_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::progressBar(parent, r, 50, nullptr);
+        });
+        benchFactory("create_check_box_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::checkBox(parent, "Check", r, false, nullptr);
+        });
+        benchFactory("create_tree_view_10k", false, [](WidgetHandle parent, const Rect &r) {
+            Widgets::treeView(parent, "Tree", r);
+        });
+        benchFactory("create_tree_item_10k", true, [](WidgetHandle parent, const Rect &) {
+            Widgets::treeItem(parent, "Item");
+        });
+    }
+
+    /// @brief Will measure the lookups, the input dispatch and full frames for one tree size.
+    /// @param[in] numPanels The number of panels with 99 children each.
+    /// @param[in] suffix    The size suffix of the benchmark names.
+    void benchScaled(size_t numPanels, const char *suffix) {
+        constexpr size_t NumOps = 1000;
+        std::vector<WidgetHandle> handles;
+        buildWidgets(numPanels, 99, handles);
+        auto &ctx = TinyUi::getContext();
+        const auto name = [suffix](const char *prefix) {
+            return std::string(prefix) + suffix;
+        };
+        const auto getX = [](size_t i) { return static_cast<int>(i * 37 % 4000); };
+        const auto getY = [](size_t i) { return static_cast<int>(i * 53 % 2500); };
+
+        size_t numFound = 0;
+        runBenchmark(name("find_widget_").c_str(), NumOps, 100, [&]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                const WidgetHandle handle = handles[i * 7919 % handles.size()];
+                numFound += Widgets::findWidget(handle, ctx.mRoot) != nullptr ? 1 : 0;
+            }
+        });
+        runBenchmark(name("get_widget_by_id_").c_str(), NumOps, 100, [&]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                numFound += Widgets::getWidgetById(handles[i * 7919 % handles.size()]) != nullptr ? 1 : 0;
+            }
+        });
+        runBenchmark(name("find_selected_widget_").c_str(), NumOps, 10, [&]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                Widget *found = nullptr;
+                Widgets::findSelectedWidget(getX(i), getY(i), ctx.mRoot, &found);
+                numFound += found != nullptr ? 1 : 0;
+            }
+        });
+        runBenchmark(name("mouse_button_").c_str(), NumOps, 10, [&]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                const int eventType = (i % 2) == 0 ? Events::MouseButtonDownEvent : Events::MouseButtonUpEvent;
+                Widgets::onMouseButton(getX(i / 2), getY(i / 2), eventType, MouseState::LeftButton);
+            }
+            ctx.mEventBus->dispatch();
+        });
+        runBenchmark(name("key_").c_str(), NumOps, 100, [&]() {
+            for (size_t i = 0; i < NumOps; ++i) {
+                const char key = static_cast<char>('a' + i % 26);
+                Widgets::onKey(&key, (i % 2) == 0);
+            }
+            ctx.mEventBus->dispatch();
+        });
+        runBenchmark(name("render_frame_").c_str(), 1, 20, []() {
+            TinyUi::invalidate();
+            TinyUi::render();
+        });
+        if (numFound == 0) {
+            printf("No widget found.\n");
+        }
+        Widgets::clear();
+    }
+
+    /// @brief Will build a form with 20 rows of a button, a checkbox, an input field and a label.
+    void buildForm() {
+        const WidgetHandle panel = Widgets::panel(WidgetHandle::getRootHandle(), "Form", Rect(0, 0, 1024, 768), nullptr);
+        for (int32_t i = 0; i < 20; ++i) {
+            const int32_t y = 10 + i * 36;
+            Widgets::textButton(panel, "Button", Rect(10, y, 120, 30), Alignment::Center, nullptr);
+            Widgets::checkBox(panel, "Check", Rect(140, y, 120, 30), false, nullptr);
+            Widgets::inputText(panel, Rect(270, y, 200, 30), Alignment::Left, KeyInputType::Character, "Input");
+            Widgets::label(panel, "Label", Rect(480, y, 200, 30), Alignment::Left);
+        }
+    }
+
+    /// @brief The rects and the text of the form alternate, all of them shall end up in a few draw calls.
+    void benchMixedScreen() {
+        buildForm();
+        runBenchmark("render_form", 1, 100, []() {
+            TinyUi::invalidate();
+            TinyUi::render();
+        });
+        report("render_form_draw_calls", getLastDrawCalls(), "count");
+        Widgets::clear();
+    }
+
+    /// @brief Records a synthetic input trace and replays it on a form as fast as possible.
+    void benchReplay() {
+        buildForm();
+
+        // Every row gets hovered, its checkbox clicked and a key typed into its input field.
+        const char *filename = "tinyui_bench_trace.bin";
+        EventRecorder recorder;
+        uint32_t time = 0;
+        recorder.begin(filename, time);
+        SDL_Event event;
+        auto click = [&](int32_t x, int32_t y) {
+            SDL_memset(&event, 0, sizeof(event));
+            event.type = SDL_MOUSEMOTION;
+            event.motion.x = x;
+            event.motion.y = y;
+            recorder.record(event, time);
+            recorder.endFrame(time += 16);
+            SDL_memset(&event, 0, sizeof(event));
+            event.type = SDL_MOUSEBUTTONDOWN;
+            event.button.button = SDL_BUTTON_LEFT;
+            event.button.x = x;
+            event.button.y = y;
+            recorder.record(event, time);
+            recorder.endFrame(time += 16);
+            event.type = SDL_MOUSEBUTTONUP;
+            recorder.record(event, time);
+            recorder.endFrame(time += 16);
+        };
+        for (int32_t i = 0; i < 20; ++i) {
+            const int32_t y = 25 + i * 36;
+            click(200, y);
+            click(370, y);
+            SDL_memset(&event, 0, sizeof(event));
+            event.type = SDL_KEYDOWN;
+            event.key.keysym.sym = 'a';
+            recorder.record(event, time);
+            event.type = SDL_KEYUP;
+            recorder.record(event, time);
+            recorder.endFrame(time += 16);
+        }
+        if (recorder.end() != ResultOk) {
+            printf("Cannot write the trace.\n");
+            Widgets::clear();
+            return;
+        }
+
+        ReplayStats stats;
+        if (TinyUi::replay(filename, ReplaySpeed::Maximum, stats) == ResultOk) {
+            report("replay_events", static_cast<double>(stats.mNumEvents), "count");
+            report("replay_frame_p50", static_cast<double>(stats.mFrameTimes.mP50), "ns");
+            report("replay_frame_p99", static_cast<double>(stats.mFrameTimes.mP99), "ns");
+            report("replay_total", static_cast<double>(stats.mTotalTime), "ns");
+        } else {
+            printf("Cannot replay the trace.\n");
+        }
+        remove(filename);
+        Widgets::clear();
+    }
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    const char *jsonFile = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonFile = argv[++i];
+        } else {
+            printf("Usage: %s [--json <file>]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    if (Style style = TinyUi::getDefaultStyle(); !TinyUi::createContext("Benchmark", style)) {
+        return -1;
+    }
+
+    // The frames are rendered by the SDL2 backend into an offscreen surface
+    if (TinyUi::initHeadlessScreen(1024, 768) == ErrorCode) {
+        const auto &ctx = TinyUi::getContext();
+        ctx.mLogger(LogSeverity::Error, "Cannot init screen");
+        return ErrorCode;
+    }
+
+    auto &ctx = TinyUi::getContext();
+    benchDrawDispatch(ctx);
+    benchRenderWidgets();
+    benchBuildWidgets();
+    benchTraversal();
+    benchCommandQueue();
+    benchEventBus();
+    benchTimerWheel();
+    benchLayout(ctx);
+    benchMoveContainer();
+    benchCulling();
+    benchProfiler();
+    benchLogger(ctx);
+    benchFactories();
+    benchScaled(10, "1k");
+    benchScaled(100, "10k");
+    benchScaled(1000, "100k");
+    benchMixedScreen();
+    benchReplay();
+
+    if (jsonFile != nullptr && !writeJsonReport(jsonFile)) {
+        printf("Cannot write %s\n", jsonFile);
+    }
+
+    TinyUi::release();
+    TinyUi::destroyContext();
+
+    return 0;
+}
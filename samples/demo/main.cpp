@@ -38,37 +38,17 @@ int quit(WidgetHandle, void *instance) {
     return ResultOk;
 }
 
-static uint32_t LastTick = 0;
-static uint32_t Diff = 0;
-static constexpr uint32_t TimeDiff = 10;
+static constexpr uint32_t ProgressInterval = 10;
 
-int updateProgressbar(WidgetHandle, void *instance) {
+void updateProgressbar(TimerId, void *instance) {
     if (instance == nullptr) {
-        return ErrorCode;
-    }
-    
-    if (LastTick == 0) {
-        LastTick = TinyUi::getTicks();
-        return ResultOk;
+        return;
     }
 
-    auto *widget = (Widget*) instance;
-    if (auto *eventPayload = (EventPayload *)widget->mContent; eventPayload->type == EventDataType::FillState) {
-        FilledState *state = (FilledState*) (eventPayload->payload);
-        uint32_t tick = TinyUi::getTicks();
-        uint32_t diff = tick - LastTick;
-        Diff += diff;
-        if (Diff > TimeDiff) {
-            state->filledState++;
-            Diff = 0;
-            if (state->filledState > 100) {
-                state->filledState = 0;
-            }
-        }
-        LastTick = tick;
-    }
-
-    return ResultOk;
+    static int fillState = 50;
+    fillState = fillState < 100 ? fillState + 1 : 0;
+    const WidgetHandle *progressBar = static_cast<const WidgetHandle*>(instance);
+    Widgets::setProgressValue(*progressBar, fillState);
 }
 
 int main(int argc, char *argv[]) {
@@ -103,10 +83,10 @@ int main(int argc, char *argv[]) {
 
     // Allocate callbacks dynamically to ensure they persist during event handling
     CallbackI *dynamicQuitCallback = new CallbackI(quit, (void*) &ctx);
-    CallbackI *dynamicUpdateProgressBarCallback = new CallbackI(updateProgressbar, nullptr, Events::UpdateEvent);
 
     Widgets::textButton(panel, "Quit", Rect(100, 300, 100, ButtonHeight), Alignment::Center, dynamicQuitCallback);
-    Widgets::progressBar(panel, Rect(100, 350, 100, ButtonHeight), 50, dynamicUpdateProgressBarCallback);
+    WidgetHandle progressBar = Widgets::progressBar(panel, Rect(100, 350, 100, ButtonHeight), 50, nullptr);
+    TinyUi::addTimer(ProgressInterval, ProgressInterval, updateProgressbar, &progressBar);
 
     Widgets::inputText(panel, Rect(100, 400, 100, ButtonHeight), Alignment::Left, KeyInputType::Character, "");
 
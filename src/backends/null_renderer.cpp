@@ -0,0 +1,130 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "null_renderer.h"
+
+namespace tinyui {
+
+ret_code NullRenderBackend::initRenderer(Context &ctx) {
+    if (ctx.mCreated) {
+        ctx.mLogger(LogSeverity::Error, "Renderer already initialized.");
+        return ErrorCode;
+    }
+    ctx.mCreated = true;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::releaseRenderer(Context &ctx) {
+    if (!ctx.mCreated) {
+        ctx.mLogger(LogSeverity::Error, "Not initialized.");
+        return ErrorCode;
+    }
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (!ctx.mCreated) {
+        ctx.mLogger(LogSeverity::Error, "Not initialized.");
+        return ErrorCode;
+    }
+    mWidth = w;
+    mHeight = h;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::releaseScreen(Context &ctx) {
+    mWidth = mHeight = 0;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r,
+        const Color4 &fgC, const Color4 &bgC, Alignment alignment) {
+    ++mNumDrawCalls;
+    ++ctx.mFrameStats.mNumTexts;
+    ++ctx.mFrameStats.mNumDrawCalls;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) {
+    ++mNumDrawCalls;
+    ++ctx.mFrameStats.mNumRects;
+    ++ctx.mFrameStats.mNumDrawCalls;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, Image *image) {
+    ++mNumDrawCalls;
+    ++ctx.mFrameStats.mNumImages;
+    ++ctx.mFrameStats.mNumDrawCalls;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::beginRender(Context &ctx, Color4 bg) {
+    mNumDrawCalls = 0;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::endRender(Context &ctx) {
+    ++mNumFrames;
+
+    return ResultOk;
+}
+
+bool NullRenderBackend::update(Context &ctx) {
+    return ctx.mCreated && !ctx.mRequestShutdown;
+}
+
+SurfaceImpl *NullRenderBackend::createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch) {
+    // There is nothing to upload, the pixels are not used anymore
+    stbi_image_free(data);
+
+    return nullptr;
+}
+
+void NullRenderBackend::releaseSurfaceImpl(SurfaceImpl *surfaceImpl) {
+    // empty
+}
+
+ret_code NullRenderBackend::getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) {
+    if (mWidth == 0 || mHeight == 0) {
+        return ErrorCode;
+    }
+    w = mWidth;
+    h = mHeight;
+
+    return ResultOk;
+}
+
+ret_code NullRenderBackend::setClipRect(Context &ctx, const Rect *rect) {
+    return ResultOk;
+}
+
+} // namespace tinyui
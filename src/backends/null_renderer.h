@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "render_backend.h"
+
+namespace tinyui {
+
+/// @brief The null render backend.
+///
+/// Nothing will be drawn, the backend only counts the issued draw calls. It can be used to
+/// measure the widget code without any driver overhead or to run the library without a display.
+struct NullRenderBackend final : RenderBackendI {
+    size_t mNumDrawCalls{0};    ///< The number of draw calls since the last beginRender.
+    size_t mNumFrames{0};       ///< The number of rendered frames.
+
+    /// @brief The default class constructor.
+    NullRenderBackend() = default;
+
+    /// @brief The class destructor.
+    ~NullRenderBackend() override = default;
+
+    ret_code initRenderer(Context &ctx) override;
+    ret_code releaseRenderer(Context &ctx) override;
+    ret_code initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h) override;
+    ret_code releaseScreen(Context &ctx) override;
+    ret_code drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r,
+        const Color4 &fgC, const Color4 &bgC, Alignment alignment) override;
+    ret_code drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) override;
+    ret_code drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, Image *image) override;
+    ret_code beginRender(Context &ctx, Color4 bg) override;
+    ret_code endRender(Context &ctx) override;
+    bool update(Context &ctx) override;
+    SurfaceImpl *createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch) override;
+    void releaseSurfaceImpl(SurfaceImpl *surfaceImpl) override;
+    ret_code getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) override;
+    ret_code setClipRect(Context &ctx, const Rect *rect) override;
+
+private:
+    int32_t mWidth{0};
+    int32_t mHeight{0};
+};
+
+} // namespace tinyui
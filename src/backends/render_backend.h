@@ -0,0 +1,169 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+namespace tinyui {
+
+/// @brief The interface for all render backends.
+///
+/// A backend will be selected by the context when the screen gets initialized. All widgets
+/// are drawn via this interface, so alternative backends like the null backend can be plugged
+/// in without touching the widget code.
+struct RenderBackendI {
+    /// @brief The class destructor, virtual.
+    virtual ~RenderBackendI() = default;
+
+    /// @brief Will initialize the renderer.
+    /// @param[in] ctx The context.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code initRenderer(Context &ctx) = 0;
+
+    /// @brief Will release the renderer.
+    /// @param[in] ctx The context.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code releaseRenderer(Context &ctx) = 0;
+
+    /// @brief Will initialize the screen.
+    /// @param[in] ctx The context.
+    /// @param[in] x   The x-coordinate of the screen.
+    /// @param[in] y   The y-coordinate of the screen.
+    /// @param[in] w   The width of the screen.
+    /// @param[in] h   The height of the screen.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h) = 0;
+
+    /// @brief Will release the screen.
+    /// @param[in] ctx The context.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code releaseScreen(Context &ctx) = 0;
+
+    /// @brief Will draw a text.
+    /// @param[in] ctx       The context.
+    /// @param[in] string    The text.
+    /// @param[in] maxLen    The number of characters.
+    /// @param[in] font      The font, nullptr for the default font.
+    /// @param[in] r         The rectangle to draw the text into.
+    /// @param[in] fgC       The foreground color.
+    /// @param[in] bgC       The background color.
+    /// @param[in] alignment The alignment of the text.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r,
+        const Color4 &fgC, const Color4 &bgC, Alignment alignment) = 0;
+
+    /// @brief Will draw a rectangle.
+    /// @param[in] ctx    The context.
+    /// @param[in] x      The x-coordinate.
+    /// @param[in] y      The y-coordinate.
+    /// @param[in] w      The width.
+    /// @param[in] h      The height.
+    /// @param[in] filled true for a filled rectangle, false for the outline only.
+    /// @param[in] fg     The color.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) = 0;
+
+    /// @brief Will draw an image.
+    /// @param[in] ctx   The context.
+    /// @param[in] x     The x-coordinate.
+    /// @param[in] y     The y-coordinate.
+    /// @param[in] w     The width.
+    /// @param[in] h     The height.
+    /// @param[in] image The image to draw.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, Image *image) = 0;
+
+    /// @brief Will begin a new frame.
+    /// @param[in] ctx The context.
+    /// @param[in] bg  The background color.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code beginRender(Context &ctx, Color4 bg) = 0;
+
+    /// @brief Will end the current frame and present it.
+    /// @param[in] ctx The context.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code endRender(Context &ctx) = 0;
+
+    /// @brief Will process all pending events.
+    /// @param[in] ctx The context.
+    /// @return false if the application shall be closed, true if not.
+    virtual bool update(Context &ctx) = 0;
+
+    /// @brief Will create the backend surface for decoded image pixels, takes the ownership of the data.
+    /// @param[in] data          The pixel data, allocated by stb_image.
+    /// @param[in] w             The width.
+    /// @param[in] h             The height.
+    /// @param[in] bytesPerPixel The number of bytes per pixel.
+    /// @param[in] pitch         The number of bytes per row.
+    /// @return The surface or nullptr in case of an error.
+    virtual SurfaceImpl *createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch) = 0;
+
+    /// @brief Will release a surface and its texture.
+    /// @param[in] surfaceImpl The surface to release.
+    virtual void releaseSurfaceImpl(SurfaceImpl *surfaceImpl) = 0;
+
+    /// @brief Will return the size of the screen.
+    /// @param[in]  ctx The context.
+    /// @param[out] w   The width.
+    /// @param[out] h   The height.
+    /// @return ResultOk if successful, ErrorCode if not.
+    virtual ret_code getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) = 0;
+
+    /// @brief Will restrict the following draw calls to a rectangle.
+    /// @param[in] ctx  The context.
+    /// @param[in] rect The clip rectangle, nullptr to disable the clipping.
+    /// @return ResultOk if successful, ErrorCode if not supported.
+    virtual ret_code setClipRect(Context &ctx, const Rect *rect) {
+        return ErrorCode;
+    }
+
+    /// @brief Will return the framebuffer, only supported by backends rendering into memory.
+    /// @param[in]  ctx         The context.
+    /// @param[out] framebuffer The framebuffer.
+    /// @return ResultOk if successful, ErrorCode if not supported.
+    virtual ret_code getFramebuffer(const Context &ctx, Framebuffer &framebuffer) {
+        return ErrorCode;
+    }
+
+    /// @brief Will set the memory budget of the text cache.
+    /// @param[in] ctx    The context.
+    /// @param[in] budget The budget in bytes.
+    /// @return ResultOk if successful, ErrorCode if not supported.
+    virtual ret_code setTextCacheBudget(Context &ctx, size_t budget) {
+        return ErrorCode;
+    }
+
+    /// @brief Will return the statistics of the text cache.
+    /// @param[in]  ctx   The context.
+    /// @param[out] stats The statistics.
+    /// @return ResultOk if successful, ErrorCode if not supported.
+    virtual ret_code getTextCacheStats(const Context &ctx, TextCacheStats &stats) {
+        return ErrorCode;
+    }
+
+    /// @brief Will wake up a blocking update call from any thread.
+    virtual void wakeUp() {}
+};
+
+} // namespace tinyui
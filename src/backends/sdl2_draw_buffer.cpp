@@ -0,0 +1,197 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "sdl2_draw_buffer.h"
+#include "sdl2_glyph_atlas.h"
+
+namespace tinyui {
+
+void DrawCommandBuffer::addRect(const SDL_Rect &r, const SDL_Color &color, bool filled) {
+    if (r.w <= 0 || r.h <= 0) {
+        return;
+    }
+
+    SDL_Texture *texture = nullptr;
+    SDL_Color fill = color;
+    float u = 0.0f;
+    float v = 0.0f;
+    if (mSolidAtlas != nullptr) {
+        // The atlas texture gets blended, the style colors are used opaque like the untextured rects
+        texture = mSolidAtlas->mTexture;
+        fill.a = 255;
+        u = mSolidAtlas->mSolidUV.x;
+        v = mSolidAtlas->mSolidUV.y;
+    }
+
+    const size_t firstIndex = mIndices.size();
+    const auto x0 = static_cast<float>(r.x);
+    const auto y0 = static_cast<float>(r.y);
+    const auto x1 = static_cast<float>(r.x + r.w);
+    const auto y1 = static_cast<float>(r.y + r.h);
+    if (filled || r.w <= 2 || r.h <= 2) {
+        addQuad(x0, y0, x1, y1, fill, u, v, u, v);
+    } else {
+        // The outline is built from four one pixel wide quads, like SDL_RenderDrawRect
+        addQuad(x0, y0, x1, y0 + 1.0f, fill, u, v, u, v);
+        addQuad(x0, y1 - 1.0f, x1, y1, fill, u, v, u, v);
+        addQuad(x0, y0 + 1.0f, x0 + 1.0f, y1 - 1.0f, fill, u, v, u, v);
+        addQuad(x1 - 1.0f, y0 + 1.0f, x1, y1 - 1.0f, fill, u, v, u, v);
+    }
+    commit(texture, firstIndex);
+}
+
+void DrawCommandBuffer::addImage(SDL_Texture *texture, const SDL_Rect &r) {
+    if (texture == nullptr) {
+        return;
+    }
+
+    const SDL_Color white = { 255, 255, 255, 255 };
+    const size_t firstIndex = mIndices.size();
+    addQuad(static_cast<float>(r.x), static_cast<float>(r.y), static_cast<float>(r.x + r.w), static_cast<float>(r.y + r.h),
+        white, 0.0f, 0.0f, 1.0f, 1.0f);
+    commit(texture, firstIndex);
+}
+
+void DrawCommandBuffer::addText(const GlyphAtlas &atlas, const char *string, size_t len, int32_t x, int32_t y,
+        const SDL_Color &color) {
+    const size_t firstIndex = mIndices.size();
+    const size_t firstVertex = mVertices.size();
+    atlas.layout(string, len, x, y, color, mVertices, mIndices);
+    if (mClipped) {
+        clipQuads(firstVertex);
+    }
+    commit(atlas.mTexture, firstIndex);
+}
+
+void DrawCommandBuffer::setSolidAtlas(const GlyphAtlas *atlas) {
+    mSolidAtlas = atlas;
+}
+
+void DrawCommandBuffer::setClipRect(const SDL_Rect *clip) {
+    mClipped = clip != nullptr;
+    if (clip != nullptr) {
+        mClip = *clip;
+    }
+}
+
+size_t DrawCommandBuffer::flush(SDL_Renderer *renderer) {
+    size_t numDrawCalls = 0;
+    if (renderer != nullptr && !mCommands.empty()) {
+        const int numVertices = static_cast<int>(mVertices.size());
+        for (const DrawCommand &cmd : mCommands) {
+            SDL_RenderGeometry(renderer, cmd.mTexture, mVertices.data(), numVertices,
+                mIndices.data() + cmd.mFirstIndex, static_cast<int>(cmd.mNumIndices));
+            ++numDrawCalls;
+        }
+    }
+    reset();
+
+    return numDrawCalls;
+}
+
+void DrawCommandBuffer::reset() {
+    mVertices.clear();
+    mIndices.clear();
+    mCommands.clear();
+    mClipped = false;
+    mSolidAtlas = nullptr;
+}
+
+void DrawCommandBuffer::addQuad(float x0, float y0, float x1, float y1, const SDL_Color &color,
+        float u0, float v0, float u1, float v1) {
+    if (mClipped) {
+        const auto cx0 = static_cast<float>(mClip.x);
+        const auto cy0 = static_cast<float>(mClip.y);
+        const auto cx1 = static_cast<float>(mClip.x + mClip.w);
+        const auto cy1 = static_cast<float>(mClip.y + mClip.h);
+        if (x1 <= cx0 || x0 >= cx1 || y1 <= cy0 || y0 >= cy1) {
+            return;
+        }
+
+        // Cut the quad and move the texture coordinates by the same ratio
+        const float du = (u1 - u0) / (x1 - x0);
+        const float dv = (v1 - v0) / (y1 - y0);
+        if (x0 < cx0) {
+            u0 += (cx0 - x0) * du;
+            x0 = cx0;
+        }
+        if (x1 > cx1) {
+            u1 -= (x1 - cx1) * du;
+            x1 = cx1;
+        }
+        if (y0 < cy0) {
+            v0 += (cy0 - y0) * dv;
+            y0 = cy0;
+        }
+        if (y1 > cy1) {
+            v1 -= (y1 - cy1) * dv;
+            y1 = cy1;
+        }
+    }
+
+    const int base = static_cast<int>(mVertices.size());
+    mVertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+    mVertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+    mVertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+    mVertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+    mIndices.push_back(base);
+    mIndices.push_back(base + 1);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base);
+    mIndices.push_back(base + 2);
+    mIndices.push_back(base + 3);
+}
+
+void DrawCommandBuffer::clipQuads(size_t firstVertex) {
+    // The glyph quads were written by the atlas, so they get rebuilt through addQuad
+    std::vector<SDL_Vertex> &quads = mClipScratch;
+    quads.assign(mVertices.begin() + static_cast<std::ptrdiff_t>(firstVertex), mVertices.end());
+    const size_t numQuads = quads.size() / 4;
+    mVertices.resize(firstVertex);
+    mIndices.resize(mIndices.size() - numQuads * 6);
+    for (size_t i = 0; i + 3 < quads.size(); i += 4) {
+        const SDL_Vertex &topLeft = quads[i];
+        const SDL_Vertex &bottomRight = quads[i + 2];
+        addQuad(topLeft.position.x, topLeft.position.y, bottomRight.position.x, bottomRight.position.y, topLeft.color,
+            topLeft.tex_coord.x, topLeft.tex_coord.y, bottomRight.tex_coord.x, bottomRight.tex_coord.y);
+    }
+}
+
+void DrawCommandBuffer::commit(SDL_Texture *texture, size_t firstIndex) {
+    const size_t numIndices = mIndices.size() - firstIndex;
+    if (numIndices == 0) {
+        return;
+    }
+
+    if (!mCommands.empty()) {
+        DrawCommand &last = mCommands.back();
+        if (last.mTexture == texture && last.mFirstIndex + last.mNumIndices == firstIndex) {
+            last.mNumIndices += numIndices;
+            return;
+        }
+    }
+
+    mCommands.push_back({ texture, firstIndex, numIndices });
+}
+
+} // namespace tinyui
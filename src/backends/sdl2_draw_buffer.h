@@ -0,0 +1,111 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <SDL.h>
+
+#include <vector>
+
+namespace tinyui {
+
+struct GlyphAtlas;
+
+/// @brief A recorded draw command, all triangles of one command share the same texture.
+struct DrawCommand {
+    SDL_Texture *mTexture{nullptr};     ///< The texture, nullptr for untextured geometry.
+    size_t       mFirstIndex{0};        ///< The first index in the index buffer.
+    size_t       mNumIndices{0};        ///< The number of indices.
+};
+
+/// @brief The draw command buffer records all draw calls of a frame.
+///
+/// Rectangles, images and text get converted into triangles. Consecutive draws using the
+/// same texture are merged into one command, so the buffer can be flushed with one
+/// SDL_RenderGeometry call per texture change instead of one driver call per widget.
+/// When a solid atlas is set, the rectangles are drawn from its white block, so rectangles
+/// and atlas text alternating in one frame still end up in one command.
+struct DrawCommandBuffer {
+    std::vector<SDL_Vertex>  mVertices;     ///< The vertex buffer.
+    std::vector<int>         mIndices;      ///< The index buffer.
+    std::vector<DrawCommand> mCommands;     ///< The recorded commands.
+    SDL_Rect                 mClip{};       ///< The clip rectangle for the following draws.
+    bool                     mClipped{false};   ///< true if the clip rectangle is active.
+    const GlyphAtlas        *mSolidAtlas{nullptr};  ///< The atlas used for the rectangles, nullptr to draw them untextured.
+
+    /// @brief Will add a rectangle.
+    /// @param[in] r      The rectangle.
+    /// @param[in] color  The color.
+    /// @param[in] filled true for a filled rectangle, false for the outline only.
+    void addRect(const SDL_Rect &r, const SDL_Color &color, bool filled);
+
+    /// @brief Will add a textured rectangle.
+    /// @param[in] texture The texture.
+    /// @param[in] r       The target rectangle.
+    void addImage(SDL_Texture *texture, const SDL_Rect &r);
+
+    /// @brief Will add a string using the glyphs from the atlas.
+    /// @param[in] atlas  The glyph atlas.
+    /// @param[in] string The string.
+    /// @param[in] len    The number of characters.
+    /// @param[in] x      The x-coordinate of the pen start position.
+    /// @param[in] y      The y-coordinate of the pen start position.
+    /// @param[in] color  The text color.
+    void addText(const GlyphAtlas &atlas, const char *string, size_t len, int32_t x, int32_t y, const SDL_Color &color);
+
+    /// @brief Will set the atlas, which white block is used to draw the rectangles.
+    /// @param[in] atlas The atlas, nullptr to draw the rectangles untextured.
+    void setSolidAtlas(const GlyphAtlas *atlas);
+
+    /// @brief Will clip all following draws against a rectangle.
+    ///
+    /// The geometry gets clipped while recording, so a clip change does not break the batches.
+    /// @param[in] clip The clip rectangle, nullptr to disable the clipping.
+    void setClipRect(const SDL_Rect *clip);
+
+    /// @brief Will submit all recorded commands and reset the buffer.
+    /// @param[in] renderer The renderer to submit to.
+    /// @return The number of issued draw calls.
+    size_t flush(SDL_Renderer *renderer);
+
+    /// @brief Will reset the buffer without submitting the commands.
+    void reset();
+
+    /// @brief Will return true, if no command was recorded.
+    /// @return true if the buffer is empty.
+    bool isEmpty() const {
+        return mCommands.empty();
+    }
+
+private:
+    void addQuad(float x0, float y0, float x1, float y1, const SDL_Color &color, float u0, float v0, float u1, float v1);
+    void commit(SDL_Texture *texture, size_t firstIndex);
+    void clipQuads(size_t firstVertex);
+
+private:
+    std::vector<SDL_Vertex>  mClipScratch;  ///< The quads to clip, reused between the calls.
+};
+
+} // namespace tinyui
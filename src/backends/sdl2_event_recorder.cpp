@@ -0,0 +1,293 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "sdl2_event_recorder.h"
+#include "sdl2_iodevice.h"
+#include "profiler.h"
+
+#include <cstdio>
+
+namespace tinyui {
+
+namespace {
+
+    struct TraceHeader {
+        uint32_t mMagic{EventRecorder::Magic};
+        uint32_t mVersion{EventRecorder::Version};
+    };
+
+    RecordedEvent makeEvent(RecordedEventType type, uint32_t time) {
+        RecordedEvent recorded;
+        recorded.mTime = time;
+        recorded.mType = static_cast<uint16_t>(type);
+        return recorded;
+    }
+
+} // namespace
+
+ret_code EventRecorder::begin(const char *filename, uint32_t now) {
+    if (filename == nullptr || mRecording) {
+        return ErrorCode;
+    }
+
+    mEvents.clear();
+    mFilename = filename;
+    mStart = now;
+    mFrameStart = 0;
+    mRecording = true;
+
+    return ResultOk;
+}
+
+void EventRecorder::record(const SDL_Event &event, uint32_t now) {
+    if (!mRecording) {
+        return;
+    }
+
+    RecordedEvent recorded = makeEvent(RecordedEventType::Count, now - mStart);
+    switch (event.type) {
+        case SDL_QUIT:
+            recorded.mType = static_cast<uint16_t>(RecordedEventType::Quit);
+            break;
+
+        case SDL_WINDOWEVENT:
+            recorded.mType = static_cast<uint16_t>(RecordedEventType::Window);
+            recorded.mCode = event.window.event;
+            recorded.mX = event.window.data1;
+            recorded.mY = event.window.data2;
+            break;
+
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            recorded.mType = static_cast<uint16_t>(event.type == SDL_MOUSEBUTTONDOWN ? RecordedEventType::MouseDown : RecordedEventType::MouseUp);
+            recorded.mCode = event.button.button;
+            recorded.mX = event.button.x;
+            recorded.mY = event.button.y;
+            break;
+
+        case SDL_MOUSEMOTION:
+            recorded.mType = static_cast<uint16_t>(RecordedEventType::MouseMove);
+            recorded.mCode = static_cast<uint16_t>(event.motion.state);
+            recorded.mX = event.motion.x;
+            recorded.mY = event.motion.y;
+            break;
+
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            recorded.mType = static_cast<uint16_t>(event.type == SDL_KEYDOWN ? RecordedEventType::KeyDown : RecordedEventType::KeyUp);
+            recorded.mCode = event.key.keysym.mod;
+            recorded.mX = event.key.keysym.sym;
+            recorded.mY = event.key.keysym.scancode;
+            break;
+
+        default:
+            // Wake-up events and all other events do not change the ui
+            return;
+    }
+    mEvents.push_back(recorded);
+}
+
+void EventRecorder::endFrame(uint32_t now) {
+    if (!mRecording || mEvents.size() == mFrameStart) {
+        return;
+    }
+
+    mEvents.push_back(makeEvent(RecordedEventType::Frame, now - mStart));
+    mFrameStart = mEvents.size();
+}
+
+ret_code EventRecorder::end() {
+    if (!mRecording) {
+        return ErrorCode;
+    }
+    mRecording = false;
+
+    FILE *file = fopen(mFilename.c_str(), "wb");
+    if (file == nullptr) {
+        return ErrorCode;
+    }
+
+    const TraceHeader header;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !mEvents.empty()) {
+        ok = fwrite(mEvents.data(), sizeof(RecordedEvent), mEvents.size(), file) == mEvents.size();
+    }
+    fclose(file);
+    mEvents.clear();
+
+    return ok ? ResultOk : ErrorCode;
+}
+
+ret_code EventReplayer::load(const char *filename) {
+    mEvents.clear();
+    if (filename == nullptr) {
+        return ErrorCode;
+    }
+
+    FILE *file = fopen(filename, "rb");
+    if (file == nullptr) {
+        return ErrorCode;
+    }
+
+    TraceHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.mMagic != EventRecorder::Magic ||
+            header.mVersion != EventRecorder::Version) {
+        fclose(file);
+        return ErrorCode;
+    }
+
+    RecordedEvent recorded;
+    while (fread(&recorded, sizeof(recorded), 1, file) == 1) {
+        if (recorded.mType >= static_cast<uint16_t>(RecordedEventType::Count)) {
+            fclose(file);
+            mEvents.clear();
+            return ErrorCode;
+        }
+        mEvents.push_back(recorded);
+    }
+    fclose(file);
+
+    // A trace without the last frame marker was cut off, the remaining events form one frame
+    if (!mEvents.empty() && mEvents.back().mType != static_cast<uint16_t>(RecordedEventType::Frame)) {
+        mEvents.push_back(makeEvent(RecordedEventType::Frame, mEvents.back().mTime));
+    }
+
+    return ResultOk;
+}
+
+bool EventReplayer::toSDLEvent(const RecordedEvent &recorded, SDL_Event &event) {
+    SDL_memset(&event, 0, sizeof(event));
+    switch (static_cast<RecordedEventType>(recorded.mType)) {
+        case RecordedEventType::Quit:
+            event.type = SDL_QUIT;
+            break;
+
+        case RecordedEventType::Window:
+            event.type = SDL_WINDOWEVENT;
+            event.window.event = static_cast<Uint8>(recorded.mCode);
+            event.window.data1 = recorded.mX;
+            event.window.data2 = recorded.mY;
+            break;
+
+        case RecordedEventType::MouseDown:
+        case RecordedEventType::MouseUp:
+            {
+                const bool down = static_cast<RecordedEventType>(recorded.mType) == RecordedEventType::MouseDown;
+                event.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+                event.button.button = static_cast<Uint8>(recorded.mCode);
+                event.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+                event.button.clicks = 1;
+                event.button.x = recorded.mX;
+                event.button.y = recorded.mY;
+            }
+            break;
+
+        case RecordedEventType::MouseMove:
+            event.type = SDL_MOUSEMOTION;
+            event.motion.state = recorded.mCode;
+            event.motion.x = recorded.mX;
+            event.motion.y = recorded.mY;
+            break;
+
+        case RecordedEventType::KeyDown:
+        case RecordedEventType::KeyUp:
+            {
+                const bool down = static_cast<RecordedEventType>(recorded.mType) == RecordedEventType::KeyDown;
+                event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+                event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+                event.key.keysym.mod = recorded.mCode;
+                event.key.keysym.sym = recorded.mX;
+                event.key.keysym.scancode = static_cast<SDL_Scancode>(recorded.mY);
+            }
+            break;
+
+        case RecordedEventType::Frame:
+        case RecordedEventType::Count:
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+ret_code EventReplayer::run(Context &ctx, ReplaySpeed speed, ReplayStats &stats) {
+    stats = ReplayStats{};
+    if (mEvents.empty() || speed == ReplaySpeed::Invalid || speed == ReplaySpeed::Count) {
+        return ErrorCode;
+    }
+
+    // The recorded frames must not block in the idle mode, the clock comes from the trace
+    const uint32_t base = TinyUi::getTicks();
+    const uint32_t start = IODevice::getTicks();
+    const bool waitForEvents = ctx.mWaitForEvents;
+    ctx.mWaitForEvents = false;
+    ctx.mReplaying = true;
+
+    std::vector<uint64_t> frameTimes;
+    bool running = true;
+    SDL_Event event;
+    for (size_t i = 0; i < mEvents.size() && running;) {
+        size_t frameEnd = i;
+        while (mEvents[frameEnd].mType != static_cast<uint16_t>(RecordedEventType::Frame)) {
+            ++frameEnd;
+        }
+        const uint32_t frameTime = mEvents[frameEnd].mTime;
+        if (speed == ReplaySpeed::Recorded) {
+            const uint32_t elapsed = IODevice::getTicks() - start;
+            if (frameTime > elapsed) {
+                IODevice::delay(frameTime - elapsed);
+            }
+        }
+
+        // Send all events of the next recorded frame
+        for (; i < frameEnd; ++i) {
+            if (toSDLEvent(mEvents[i], event)) {
+                IODevice::sendEvent(event);
+                ++stats.mNumEvents;
+            }
+        }
+        ++i;
+
+        ctx.mReplayTicks = base + frameTime;
+        const uint64_t frameStart = Profiler::now();
+        running = TinyUi::run();
+        TinyUi::render();
+        frameTimes.push_back(Profiler::now() - frameStart);
+    }
+
+    // The replayed clock may be ahead of the device, the ticks must not go back
+    const uint32_t now = IODevice::getTicks();
+    if (static_cast<int32_t>(ctx.mReplayTicks - (now + ctx.mTickOffset)) > 0) {
+        ctx.mTickOffset = ctx.mReplayTicks - now;
+    }
+    ctx.mReplaying = false;
+    ctx.mWaitForEvents = waitForEvents;
+
+    for (const uint64_t time : frameTimes) {
+        stats.mTotalTime += time;
+    }
+
+    return Profiler::computeFrameTimeStats(frameTimes, stats.mFrameTimes);
+}
+
+} // namespace tinyui
@@ -0,0 +1,132 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <SDL.h>
+
+#include <string>
+#include <vector>
+
+namespace tinyui {
+
+/// @brief A recorded input event, stored in the trace file as it is.
+struct RecordedEvent {
+    uint32_t mTime{0};      ///< The time since the begin of the recording in ms.
+    uint16_t mType{0};      ///< The RecordedEventType.
+    uint16_t mCode{0};      ///< The button, the button mask, the key modifiers or the window event.
+    int32_t  mX{0};         ///< The x-coordinate, the key symbol or the first window parameter.
+    int32_t  mY{0};         ///< The y-coordinate, the scan code or the second window parameter.
+};
+
+static_assert(sizeof(RecordedEvent) == 16, "The trace records must be packed.");
+
+/// @brief The type of a recorded event.
+enum class RecordedEventType : uint16_t {
+    Frame = 0,      ///< The end of an update, all events before were handled in one frame.
+    Quit,           ///< The application shall be closed.
+    Window,         ///< A window event.
+    MouseDown,      ///< A mouse button was pressed.
+    MouseUp,        ///< A mouse button was released.
+    MouseMove,      ///< The mouse was moved.
+    KeyDown,        ///< A key was pressed.
+    KeyUp,          ///< A key was released.
+    Count           ///< The number of event types.
+};
+
+/// @brief Records the input events polled by the IODevice.
+///
+/// The events are stored in memory while recording, the trace file gets written when the
+/// recording ends. The file starts with the magic number and the version, followed by the
+/// native-endian RecordedEvent records.
+struct EventRecorder {
+    static constexpr uint32_t Magic = 0x52495554;   ///< "TUIR"
+    static constexpr uint32_t Version = 1;          ///< The version of the trace format.
+
+    /// @brief Will start a new recording.
+    /// @param[in] filename The name of the trace file.
+    /// @param[in] now      The current ticks in ms.
+    /// @return ResultOk if the recording was started, ErrorCode if a recording is running.
+    ret_code begin(const char *filename, uint32_t now);
+
+    /// @brief Will record an event, events which do not change the ui are ignored.
+    /// @param[in] event    The SDL event.
+    /// @param[in] now      The current ticks in ms.
+    void record(const SDL_Event &event, uint32_t now);
+
+    /// @brief Will mark the end of an update, if events were recorded since the last one.
+    ///
+    /// The time of the marker is the clock of the replayed frame.
+    /// @param[in] now      The current ticks in ms.
+    void endFrame(uint32_t now);
+
+    /// @brief Will stop the recording and write the trace file.
+    /// @return ResultOk if the file was written, ErrorCode if not.
+    ret_code end();
+
+    /// @brief Will return true while recording.
+    /// @return true if recording.
+    bool isRecording() const {
+        return mRecording;
+    }
+
+private:
+    std::vector<RecordedEvent> mEvents;
+    std::string                mFilename;
+    uint32_t                   mStart{0};
+    size_t                     mFrameStart{0};
+    bool                       mRecording{false};
+};
+
+/// @brief Replays a recorded trace on the current screen.
+///
+/// The events of every recorded frame are sent through the IODevice, followed by one
+/// TinyUi::run and TinyUi::render call. The time of these calls is the measured frame time.
+/// While replaying, TinyUi::getTicks returns the recorded time of the frame, so the timers
+/// and the update callbacks run the same way in every replay.
+struct EventReplayer {
+    /// @brief Will load a trace file.
+    /// @param[in] filename The name of the trace file.
+    /// @return ResultOk if the trace was loaded, ErrorCode if not.
+    ret_code load(const char *filename);
+
+    /// @brief Will replay the loaded trace.
+    /// @param[in]  ctx     The context.
+    /// @param[in]  speed   The replay speed.
+    /// @param[out] stats   The frame times of the replay.
+    /// @return ResultOk if the trace was replayed, ErrorCode if not.
+    ret_code run(Context &ctx, ReplaySpeed speed, ReplayStats &stats);
+
+    /// @brief Will convert a recorded event into an SDL event.
+    /// @param[in]  recorded    The recorded event.
+    /// @param[out] event       The SDL event.
+    /// @return true if the event was converted, false for frame markers.
+    static bool toSDLEvent(const RecordedEvent &recorded, SDL_Event &event);
+
+private:
+    std::vector<RecordedEvent> mEvents;
+};
+
+} // namespace tinyui
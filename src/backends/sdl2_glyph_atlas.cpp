@@ -0,0 +1,205 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "sdl2_glyph_atlas.h"
+
+#include <cassert>
+
+namespace tinyui {
+
+namespace {
+
+    constexpr int32_t AtlasWidth = 512;
+
+    int32_t nextPowerOfTwo(int32_t value) {
+        int32_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void releaseGlyphSurfaces(SDL_Surface **surfaces) {
+        for (uint32_t i = 0; i < GlyphAtlas::NumGlyphs; ++i) {
+            if (surfaces[i] != nullptr) {
+                SDL_FreeSurface(surfaces[i]);
+                surfaces[i] = nullptr;
+            }
+        }
+    }
+
+} // Anonymous namespace
+
+GlyphAtlas *GlyphAtlas::create(SDL_Renderer *renderer, TTF_Font *font) {
+    if (renderer == nullptr || font == nullptr) {
+        return nullptr;
+    }
+
+    // Rasterize all glyphs in white, the text color will be applied by the vertex color
+    const SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Surface *surfaces[NumGlyphs] = { nullptr };
+    auto *atlas = new GlyphAtlas;
+    atlas->mLineHeight = TTF_FontHeight(font);
+
+    // The first row starts behind the white block
+    int32_t x = Padding + SolidSize + Padding;
+    int32_t y = Padding;
+    int32_t rowHeight = SolidSize;
+    for (uint32_t i = 0; i < NumGlyphs; ++i) {
+        const char glyph[2] = { static_cast<char>(FirstGlyph + i), '\0' };
+        int w{ 0 };
+        int h{ 0 };
+        if (TTF_SizeText(font, glyph, &w, &h) != 0) {
+            continue;
+        }
+
+        GlyphInfo &info = atlas->mGlyphs[i];
+        info.mAdvance = w;
+        if (glyph[0] == ' ') {
+            continue;
+        }
+
+        surfaces[i] = TTF_RenderText_Blended(font, glyph, white);
+        if (surfaces[i] == nullptr) {
+            continue;
+        }
+
+        w = surfaces[i]->w;
+        h = surfaces[i]->h;
+        if (x + w + Padding > AtlasWidth) {
+            x = Padding;
+            y += rowHeight + Padding;
+            rowHeight = 0;
+        }
+        info.mRect = { x, y, w, h };
+        x += w + Padding;
+        if (h > rowHeight) {
+            rowHeight = h;
+        }
+    }
+
+    atlas->mWidth = AtlasWidth;
+    atlas->mHeight = nextPowerOfTwo(y + rowHeight + Padding);
+    SDL_Surface *atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlas->mWidth, atlas->mHeight, 32, SDL_PIXELFORMAT_RGBA32);
+    if (atlasSurface == nullptr) {
+        releaseGlyphSurfaces(surfaces);
+        delete atlas;
+        return nullptr;
+    }
+
+    SDL_FillRect(atlasSurface, nullptr, 0);
+    const SDL_Rect solidRect = { Padding, Padding, SolidSize, SolidSize };
+    SDL_FillRect(atlasSurface, &solidRect, SDL_MapRGBA(atlasSurface->format, 255, 255, 255, 255));
+    atlas->mSolidUV.x = static_cast<float>(Padding + SolidSize / 2) / static_cast<float>(atlas->mWidth);
+    atlas->mSolidUV.y = static_cast<float>(Padding + SolidSize / 2) / static_cast<float>(atlas->mHeight);
+    for (uint32_t i = 0; i < NumGlyphs; ++i) {
+        if (surfaces[i] == nullptr) {
+            continue;
+        }
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(surfaces[i], nullptr, atlasSurface, &atlas->mGlyphs[i].mRect);
+    }
+    releaseGlyphSurfaces(surfaces);
+
+    atlas->mTexture = SDL_CreateTextureFromSurface(renderer, atlasSurface);
+    SDL_FreeSurface(atlasSurface);
+    if (atlas->mTexture == nullptr) {
+        delete atlas;
+        return nullptr;
+    }
+    SDL_SetTextureBlendMode(atlas->mTexture, SDL_BLENDMODE_BLEND);
+
+    return atlas;
+}
+
+void GlyphAtlas::destroy(GlyphAtlas *atlas) {
+    if (atlas == nullptr) {
+        return;
+    }
+
+    if (atlas->mTexture != nullptr) {
+        SDL_DestroyTexture(atlas->mTexture);
+        atlas->mTexture = nullptr;
+    }
+    delete atlas;
+}
+
+const GlyphInfo &GlyphAtlas::getGlyph(char c) const {
+    auto index = static_cast<uint32_t>(static_cast<unsigned char>(c));
+    if (index < FirstGlyph || index > LastGlyph) {
+        index = static_cast<uint32_t>('?');
+    }
+
+    return mGlyphs[index - FirstGlyph];
+}
+
+int32_t GlyphAtlas::measure(const char *string, size_t len) const {
+    if (string == nullptr) {
+        return 0;
+    }
+
+    int32_t width = 0;
+    for (size_t i = 0; i < len && string[i] != '\0'; ++i) {
+        width += getGlyph(string[i]).mAdvance;
+    }
+
+    return width;
+}
+
+void GlyphAtlas::layout(const char *string, size_t len, int32_t x, int32_t y, const SDL_Color &color,
+        std::vector<SDL_Vertex> &vertices, std::vector<int> &indices) const {
+    assert(string != nullptr);
+
+    const float invW = 1.0f / static_cast<float>(mWidth);
+    const float invH = 1.0f / static_cast<float>(mHeight);
+    int32_t penX = x;
+    for (size_t i = 0; i < len && string[i] != '\0'; ++i) {
+        const GlyphInfo &glyph = getGlyph(string[i]);
+        const SDL_Rect &src = glyph.mRect;
+        if (src.w > 0 && src.h > 0) {
+            const float x0 = static_cast<float>(penX);
+            const float y0 = static_cast<float>(y);
+            const float x1 = x0 + static_cast<float>(src.w);
+            const float y1 = y0 + static_cast<float>(src.h);
+            const float u0 = static_cast<float>(src.x) * invW;
+            const float v0 = static_cast<float>(src.y) * invH;
+            const float u1 = static_cast<float>(src.x + src.w) * invW;
+            const float v1 = static_cast<float>(src.y + src.h) * invH;
+
+            const int base = static_cast<int>(vertices.size());
+            vertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+            vertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+            vertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+            vertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+            indices.push_back(base);
+            indices.push_back(base + 1);
+            indices.push_back(base + 2);
+            indices.push_back(base);
+            indices.push_back(base + 2);
+            indices.push_back(base + 3);
+        }
+        penX += glyph.mAdvance;
+    }
+}
+
+} // namespace tinyui
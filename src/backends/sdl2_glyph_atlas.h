@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <vector>
+
+namespace tinyui {
+
+/// @brief The position and metrics of one glyph inside the glyph atlas.
+struct GlyphInfo {
+    SDL_Rect mRect{};       ///< The glyph rectangle inside the atlas texture.
+    int32_t  mAdvance{0};   ///< The horizontal advance to the next glyph.
+};
+
+/// @brief The glyph atlas stores all printable glyphs of one font in a single texture.
+///
+/// The glyphs get rasterized once per font and size. Strings are drawn as a batch of
+/// textured quads referencing the atlas, so no surface or texture needs to be created
+/// per draw call. A white block in the top left corner is used for the solid rectangles,
+/// so they can share the batches with the text.
+struct GlyphAtlas {
+    static constexpr uint32_t FirstGlyph = 32;                          ///< The first glyph in the atlas (space).
+    static constexpr uint32_t LastGlyph = 126;                          ///< The last glyph in the atlas (tilde).
+    static constexpr uint32_t NumGlyphs = LastGlyph - FirstGlyph + 1;   ///< The number of glyphs in the atlas.
+    static constexpr int32_t  Padding = 1;                              ///< The padding between two glyphs in pixels.
+    static constexpr int32_t  SolidSize = 4;                            ///< The size of the white block in pixels.
+
+    SDL_Texture *mTexture{nullptr};     ///< The atlas texture.
+    int32_t      mWidth{0};             ///< The width of the atlas texture.
+    int32_t      mHeight{0};            ///< The height of the atlas texture.
+    int32_t      mLineHeight{0};        ///< The line height of the font.
+    GlyphInfo    mGlyphs[NumGlyphs];    ///< The glyph infos.
+    SDL_FPoint   mSolidUV{};            ///< The texture coordinate of the white block center.
+
+    /// @brief Will rasterize all printable glyphs of a font into a new atlas.
+    /// @param[in] renderer The renderer used to create the atlas texture.
+    /// @param[in] font     The font to rasterize.
+    /// @return The new atlas or nullptr in case of an error.
+    static GlyphAtlas *create(SDL_Renderer *renderer, TTF_Font *font);
+
+    /// @brief Will destroy the atlas and its texture.
+    /// @param[in] atlas The atlas to destroy.
+    static void destroy(GlyphAtlas *atlas);
+
+    /// @brief Will return the glyph info for a character, unknown characters will be mapped to '?'.
+    /// @param[in] c The character.
+    /// @return The glyph info.
+    const GlyphInfo &getGlyph(char c) const;
+
+    /// @brief Will measure the width of a string in pixels.
+    /// @param[in] string The string to measure.
+    /// @param[in] len    The number of characters to measure.
+    /// @return The width in pixels.
+    int32_t measure(const char *string, size_t len) const;
+
+    /// @brief Will append the quads for a string to the vertex and index buffer.
+    /// @param[in]  string   The string to layout.
+    /// @param[in]  len      The number of characters.
+    /// @param[in]  x        The x-coordinate of the pen start position.
+    /// @param[in]  y        The y-coordinate of the pen start position.
+    /// @param[in]  color    The text color.
+    /// @param[out] vertices The vertex buffer to append to.
+    /// @param[out] indices  The index buffer to append to.
+    void layout(const char *string, size_t len, int32_t x, int32_t y, const SDL_Color &color,
+        std::vector<SDL_Vertex> &vertices, std::vector<int> &indices) const;
+
+private:
+    GlyphAtlas() = default;
+    ~GlyphAtlas() = default;
+};
+
+} // namespace tinyui
@@ -22,12 +22,58 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include "sdl2_iodevice.h"
+#include "sdl2_event_recorder.h"
 #include "SDL_timer.h"
 
 namespace tinyui {
 
+static constexpr Uint32 InvalidEventType = static_cast<Uint32>(-1);
+static Uint32 WakeUpEventType = InvalidEventType;
+static EventRecorder *Recorder = nullptr;
+
+static void recordEvent(const SDL_Event &event) {
+    if (Recorder != nullptr) {
+        Recorder->record(event, IODevice::getTicks());
+    }
+}
+
 bool IODevice::update(SDL_Event &event) {
-     return SDL_PollEvent(&event);
+    if (SDL_PollEvent(&event) == 0) {
+        return false;
+    }
+    recordEvent(event);
+
+    return true;
+}
+
+bool IODevice::waitEvent(SDL_Event &event, int32_t timeoutMs) {
+    if (SDL_WaitEventTimeout(&event, timeoutMs) == 0) {
+        return false;
+    }
+    recordEvent(event);
+
+    return true;
+}
+
+void IODevice::registerWakeUpEvent() {
+    if (WakeUpEventType == InvalidEventType) {
+        WakeUpEventType = SDL_RegisterEvents(1);
+    }
+}
+
+void IODevice::wakeUp() {
+    if (WakeUpEventType == InvalidEventType) {
+        return;
+    }
+
+    SDL_Event event;
+    SDL_memset(&event, 0, sizeof(event));
+    event.type = WakeUpEventType;
+    SDL_PushEvent(&event);
+}
+
+void IODevice::setRecorder(EventRecorder *recorder) {
+    Recorder = recorder;
 }
 
 void IODevice::sendEvent( SDL_Event &event) {
@@ -27,10 +27,15 @@ SOFTWARE.
 
 namespace tinyui {
 
+struct EventRecorder;
+
 /// @brief the SDL2 implementation for an io-device.
 ///
 /// IO-Devices are used to contrl any kind of input / output operations.
 struct IODevice {
+    /// The timeout to wait until the next event arrives.
+    static constexpr int32_t WaitForever = -1;
+
     /// @brief Default destructor.
     ~IODevice() = default;
 
@@ -39,6 +44,22 @@ struct IODevice {
     /// @return true if an event was polled, false if not.
     static bool update(SDL_Event &event);
 
+    /// @brief Will block until an event arrives or the timeout is reached.
+    /// @param event     The event to fill with data.
+    /// @param timeoutMs The timeout in milliseconds, WaitForever to wait without a timeout.
+    /// @return true if an event was received, false if the timeout was reached.
+    static bool waitEvent(SDL_Event &event, int32_t timeoutMs);
+
+    /// @brief Will register the wake-up event type, call this once after the event subsystem was initialized.
+    static void registerWakeUpEvent();
+
+    /// @brief Will wake up a thread blocked in waitEvent, can be called from any thread.
+    static void wakeUp();
+
+    /// @brief Will set the recorder for the polled events.
+    /// @param recorder The recorder, nullptr to stop recording.
+    static void setRecorder(EventRecorder *recorder);
+
     /// @brief Send an event to the io-device.
     /// @param event The event to send.
     static void sendEvent(SDL_Event &event);
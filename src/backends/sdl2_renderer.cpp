@@ -24,7 +24,12 @@ SOFTWARE.
 #include "sdl2_renderer.h"
 #include "sdl2_iodevice.h"
 #include "widgets.h"
+#include "timer_wheel.h"
+#include "layout.h"
+#include "logger.h"
 
+#include <algorithm>
+#include <climits>
 #include <cassert>
 #include <iostream>
 
@@ -134,6 +139,28 @@ namespace {
         return state;
     }
 
+    MouseState getMotionState(const SDL_MouseMotionEvent &m) {
+        if ((m.state & SDL_BUTTON_LMASK) != 0) {
+            return MouseState::LeftButton;
+        }
+        if ((m.state & SDL_BUTTON_MMASK) != 0) {
+            return MouseState::MiddleButton;
+        }
+        if ((m.state & SDL_BUTTON_RMASK) != 0) {
+            return MouseState::RightButton;
+        }
+
+        return MouseState::Invalid;
+    }
+
+    /// @brief The last mouse motion of one update, all motion events get coalesced into it.
+    struct MouseMotion {
+        bool       mMoved{false};
+        int32_t    mX{0};
+        int32_t    mY{0};
+        MouseState mState{MouseState::Invalid};
+    };
+
     int32_t getEventType(Uint32 sdlType) {
         switch (sdlType) {
             case SDL_QUIT:
@@ -142,25 +169,283 @@ namespace {
                 return Events::MouseButtonDownEvent;
             case SDL_MOUSEBUTTONUP:
                 return Events::MouseButtonUpEvent;
+            case SDL_MOUSEMOTION:
+                return Events::MouseMoveEvent;
         }
         return Events::InvalidEvent;
     }
 
+    Point2i getTextPosition(const Context &ctx, const Rect &r, int32_t textWidth, int32_t lineHeight, Alignment alignment) {
+        const int32_t margin{ctx.mStyle.mMargin};
+        Point2i pos(r.top.x, r.top.y + (r.height - lineHeight) / 2);
+        switch (alignment) {
+            case Alignment::Left:
+                pos.x = r.top.x + margin;
+                break;
+            case Alignment::Center:
+                pos.x = r.top.x + (r.width - textWidth) / 2;
+                break;
+            case Alignment::Right:
+                pos.x = r.top.x + r.width - margin - textWidth;
+                break;
+            case Alignment::Invalid:
+            case Alignment::Count:
+            default:
+                assert(false && "Not supported alignment.");
+                break;
+        }
+
+        return pos;
+    }
+
+    bool isAtlasText(const char *string, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            const auto c = static_cast<unsigned char>(string[i]);
+            if (c < GlyphAtlas::FirstGlyph || c > GlyphAtlas::LastGlyph) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t packColor(const SDL_Color &col) {
+        return (static_cast<uint32_t>(col.r) << 24) | (static_cast<uint32_t>(col.g) << 16) |
+            (static_cast<uint32_t>(col.b) << 8) | static_cast<uint32_t>(col.a);
+    }
+
+    ret_code drawCachedText(Context &ctx, SDLContext *sdlCtx, const char *string, size_t len, const Font *font, const Rect &r,
+            const SDL_Color &textColor, Alignment alignment) {
+        TextCacheKey key;
+        key.mText.assign(string, len);
+        key.mFont = font->mFont;
+        key.mSize = font->mSize;
+        key.mColor = packColor(textColor);
+        const TextCacheEntry *entry = sdlCtx->mTextCache.find(key);
+        if (entry != nullptr) {
+            ++ctx.mFrameStats.mNumTextCacheHits;
+        } else {
+            ++ctx.mFrameStats.mNumTextCacheMisses;
+            SDL_Surface *surface = TTF_RenderUTF8_Blended(font->mFont->mFontImpl, key.mText.c_str(), textColor);
+            if (surface == nullptr) {
+                TINYUI_LOG(ctx, LogSeverity::Error, "Cannot create message surface.%s.", SDL_GetError());
+                return ErrorCode;
+            }
+
+            SDL_Texture *texture = SDL_CreateTextureFromSurface(sdlCtx->mRenderer, surface);
+            const int32_t w = surface->w;
+            const int32_t h = surface->h;
+            SDL_FreeSurface(surface);
+            if (texture == nullptr) {
+                TINYUI_LOG(ctx, LogSeverity::Error, "Cannot create texture: %s.", SDL_GetError());
+                return ErrorCode;
+            }
+            ++ctx.mFrameStats.mNumTexturesCreated;
+            ++ctx.mFrameStats.mNumTextureUploads;
+            entry = sdlCtx->mTextCache.insert(key, texture, w, h);
+        }
+
+        const Point2i pos = getTextPosition(ctx, r, entry->mWidth, entry->mHeight, alignment);
+        const SDL_Rect dstRect = { pos.x, pos.y, entry->mWidth, entry->mHeight };
+        sdlCtx->mDrawBuffer.addImage(entry->mTexture, dstRect);
+
+        return ResultOk;
+    }
+
+    GlyphAtlas *getGlyphAtlas(Context &ctx, SDLContext *sdlCtx, Font *font) {
+        if (font->mFont->mAtlas == nullptr) {
+            font->mFont->mAtlas = GlyphAtlas::create(sdlCtx->mRenderer, font->mFont->mFontImpl);
+            if (font->mFont->mAtlas == nullptr) {
+                TINYUI_LOG(ctx, LogSeverity::Error, "Cannot create glyph atlas: %s.", SDL_GetError());
+                return nullptr;
+            }
+            ++ctx.mFrameStats.mNumTexturesCreated;
+            ++ctx.mFrameStats.mNumTextureUploads;
+        }
+
+        return font->mFont->mAtlas;
+    }
+
+    void releaseFrameTarget(SDLContext *sdlCtx) {
+        if (sdlCtx->mFrameTarget != nullptr) {
+            SDL_DestroyTexture(sdlCtx->mFrameTarget);
+            sdlCtx->mFrameTarget = nullptr;
+        }
+        sdlCtx->mFrameTargetActive = false;
+    }
+
+    void releaseFontAtlas(Font *font) {
+        if (font != nullptr && font->mFont != nullptr && font->mFont->mAtlas != nullptr) {
+            GlyphAtlas::destroy(font->mFont->mAtlas);
+            font->mFont->mAtlas = nullptr;
+        }
+    }
+
+    /// Releases the textures lost by a device reset, they get created again on their next draw.
+    void releaseDeviceTextures(Context &ctx, SDLContext *sdlCtx) {
+        releaseFrameTarget(sdlCtx);
+        sdlCtx->mTextCache.clear();
+        releaseFontAtlas(ctx.mDefaultFont);
+        for (auto &entry : ctx.mFontCache) {
+            releaseFontAtlas(entry.second);
+        }
+
+        // Images without the CPU-side pixels cannot be uploaded again
+        for (auto &entry : ctx.mImageCache) {
+            SurfaceImpl *surfaceImpl = entry.second != nullptr ? entry.second->mSurfaceImpl : nullptr;
+            if (surfaceImpl != nullptr && surfaceImpl->mSurface != nullptr && surfaceImpl->mTexture != nullptr) {
+                SDL_DestroyTexture(surfaceImpl->mTexture);
+                surfaceImpl->mTexture = nullptr;
+            }
+        }
+    }
+
+    /// Binds the retained frame texture, returns true if its content from the last frame is still valid.
+    bool bindFrameTarget(Context &ctx, SDLContext *sdlCtx) {
+        SDL_SetRenderTarget(sdlCtx->mRenderer, nullptr);
+        int w{ 0 };
+        int h{ 0 };
+        if (SDL_GetRendererOutputSize(sdlCtx->mRenderer, &w, &h) != 0 || w <= 0 || h <= 0) {
+            releaseFrameTarget(sdlCtx);
+            return false;
+        }
+
+        bool retained = false;
+        if (sdlCtx->mFrameTarget != nullptr) {
+            int targetW{ 0 };
+            int targetH{ 0 };
+            SDL_QueryTexture(sdlCtx->mFrameTarget, nullptr, nullptr, &targetW, &targetH);
+            if (targetW == w && targetH == h) {
+                retained = true;
+            } else {
+                releaseFrameTarget(sdlCtx);
+            }
+        }
+
+        if (sdlCtx->mFrameTarget == nullptr) {
+            sdlCtx->mFrameTarget = SDL_CreateTexture(sdlCtx->mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+            if (sdlCtx->mFrameTarget == nullptr) {
+                TINYUI_TRACE("Cannot create retained frame texture, using full redraws.");
+                return false;
+            }
+            ++ctx.mFrameStats.mNumTexturesCreated;
+        }
+
+        sdlCtx->mFrameTargetActive = SDL_SetRenderTarget(sdlCtx->mRenderer, sdlCtx->mFrameTarget) == 0;
+
+        return retained && sdlCtx->mFrameTargetActive;
+    }
+
+    int32_t getIdleTimeout(const Context &ctx) {
+        if (ctx.mDirtyRegion.isDirty()) {
+            return 0;
+        }
+
+        uint32_t timeout = ctx.mTimers->getNextTimeout(TinyUi::getTicks());
+        if (!ctx.mUpdateCallbackList.empty()) {
+            // The update callbacks have no due time, so they are polled with the update interval
+            timeout = std::min(timeout, ctx.mUpdateInterval);
+        }
+        if (timeout == TimerWheel::NoTimeout) {
+            return IODevice::WaitForever;
+        }
+
+        return static_cast<int32_t>(std::min<uint32_t>(timeout, INT32_MAX));
+    }
+
+    bool handleEvent(Context &ctx, const SDL_Event &event, MouseMotion &motion) {
+        switch (event.type) {
+            case SDL_QUIT:
+                return false;
+
+            case SDL_WINDOWEVENT:
+                switch (event.window.event) {
+                    case SDL_WINDOWEVENT_SIZE_CHANGED:
+                        Layout::setViewport(ctx, Rect(0, 0, event.window.data1, event.window.data2));
+                        ctx.mDirtyRegion.invalidateAll();
+                        break;
+                    case SDL_WINDOWEVENT_EXPOSED:
+                    case SDL_WINDOWEVENT_RESTORED:
+                    case SDL_WINDOWEVENT_SHOWN:
+                        ctx.mDirtyRegion.invalidateAll();
+                        break;
+                    default:
+                        // Focus changes, mouse enter and leave do not touch the window content
+                        break;
+                }
+                break;
+
+            case SDL_RENDER_TARGETS_RESET:
+                // The retained frame lost its content, so the next frame must not be a partial one
+                releaseFrameTarget(getBackendContext(ctx));
+                ctx.mDirtyRegion.invalidateAll();
+                break;
+
+            case SDL_RENDER_DEVICE_RESET:
+                releaseDeviceTextures(ctx, getBackendContext(ctx));
+                ctx.mDirtyRegion.invalidateAll();
+                break;
+
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+                {
+                    const int32_t x = event.button.x;
+                    const int32_t y = event.button.y;
+                    Widgets::onMouseButton(x, y, getEventType(event.type), getButtonState(event.button));
+                } break;
+
+            case SDL_MOUSEMOTION:
+                {
+                    // Only the last position is relevant, the hit test is done once per update
+                    motion.mMoved = true;
+                    motion.mX = event.motion.x;
+                    motion.mY = event.motion.y;
+                    motion.mState = getMotionState(event.motion);
+                } break;
+
+            case SDL_KEYDOWN:
+                {
+                    const char *key = SDL_GetKeyName(event.key.keysym.sym);
+                    if (key == nullptr) {
+                        break;
+                    }
+                    Widgets::onKey(key, true);
+                } break;
+
+            case SDL_KEYUP: 
+                {
+                    const char *key = SDL_GetKeyName(event.key.keysym.sym);
+                    if (key == nullptr) {
+                        break;
+                    }
+                    Widgets::onKey(key, false);
+                } break;
+
+            default:
+                // Wake-up events and all other events are only used to leave the idle wait
+                break;
+        }
+
+        return true;
+    }
+
 } // Anonymous namespace
 
-ret_code Renderer::initRenderer(Context &ctx) {
+ret_code Renderer::initRenderer(Context &ctx, bool headless) {
     if (ctx.mCreated) {
         ctx.mLogger(LogSeverity::Error, "Renderer already initialized.");
         return ErrorCode;
     }
 
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) == -1) {
+    // The headless mode does not need a display, so the video subsystem will not be initialized
+    const Uint32 subsystems = headless ? (SDL_INIT_EVENTS | SDL_INIT_TIMER) : (SDL_INIT_VIDEO | SDL_INIT_TIMER);
+    if (SDL_Init(subsystems) == -1) {
         ctx.mLogger(LogSeverity::Error, "Error while SDL_Init for video subsystem.");
         ctx.mCreated = false;
         return ErrorCode;
     }
 
     ctx.mCreated = true;
+    IODevice::registerWakeUpEvent();
 
 #ifdef TINYUI_TRACE_ENABLED
     listAllRenderDivers(ctx);
@@ -182,6 +467,7 @@ ret_code Renderer::releaseRenderer(Context &ctx) {
     }
 
     if (ctx.mDefaultFont != nullptr) {
+        delete ctx.mDefaultFont->mFont;
         delete ctx.mDefaultFont;
         ctx.mDefaultFont = nullptr;
     }
@@ -193,6 +479,8 @@ ret_code Renderer::releaseRenderer(Context &ctx) {
     }
 
     if (SDLContext *sdlCtx = getBackendContext(ctx); sdlCtx->mRenderer != nullptr) {
+        sdlCtx->mTextCache.clear();
+        releaseFrameTarget(sdlCtx);
         SDL_DestroyRenderer(sdlCtx->mRenderer);
         sdlCtx->mRenderer = nullptr;
     }
@@ -211,8 +499,7 @@ ret_code Renderer::drawText(Context &ctx, const char *string, size_t maxLen, Fon
         if (ctx.mStyle.mFont.mName != nullptr) {
             loadFont(ctx);
             if (font == nullptr) {
-                const std::string msg = "Cannot load font: " + std::string(ctx.mStyle.mFont.mName) + ", using the default font.";
-                ctx.mLogger(LogSeverity::Error, msg.c_str());
+                TINYUI_LOG(ctx, LogSeverity::Error, "Cannot load font: %s, using the default font.", ctx.mStyle.mFont.mName);
                 font = ctx.mDefaultFont;
             }
         }
@@ -223,54 +510,25 @@ ret_code Renderer::drawText(Context &ctx, const char *string, size_t maxLen, Fon
         return InvalidHandle;
     }
 
-    SDL_Color text_color = getSDLColor(fgC);
-    SDL_Surface *surfaceMessage = TTF_RenderText_Solid(font->mFont->mFontImpl, string, text_color);
-    if (surfaceMessage == nullptr) {
-        const std::string msg = "Cannot create message surface." + std::string(SDL_GetError()) + ".";
-        ctx.mLogger(LogSeverity::Error, msg.c_str());
-        return ErrorCode;
+    // The style colors are used opaque, the glyph coverage is stored in the alpha channel
+    SDL_Color textColor = getSDLColor(fgC);
+    textColor.a = 255;
+    SDLContext *sdlCtx = getBackendContext(ctx);
+    ++ctx.mFrameStats.mNumTexts;
+    const size_t stringLen = strnlen(string, maxLen);
+    if (!isAtlasText(string, stringLen)) {
+        return drawCachedText(ctx, sdlCtx, string, stringLen, font, r, textColor, alignment);
     }
 
-    SDLContext *sdlCtx = getBackendContext(ctx);
-    SDL_Texture *messageTexture = SDL_CreateTextureFromSurface(sdlCtx->mRenderer, surfaceMessage);
-    if (messageTexture == nullptr) {
-        const std::string msg = "Cannot create texture: " + std::string(SDL_GetError()) + ".";
-        ctx.mLogger(LogSeverity::Error, msg.c_str());
+    const GlyphAtlas *atlas = getGlyphAtlas(ctx, sdlCtx, font);
+    if (atlas == nullptr) {
         return ErrorCode;
     }
 
-    const size_t stringLen = strnlen(string, maxLen);
-    int32_t margin{ctx.mStyle.mMargin};
-    SDL_Rect Message_rect{};
-    switch (alignment) {
-        case Alignment::Left:
-            Message_rect.x = r.top.x + margin;
-            Message_rect.y = r.top.y + margin;
-            Message_rect.w = font->mSize*static_cast<int>(stringLen);
-            Message_rect.h = font->mSize + margin*2;
-            break;
-        case Alignment::Center:
-            Message_rect.x = r.top.x + 2 * margin + surfaceMessage->clip_rect.w / 2;
-            Message_rect.y = r.top.y + margin;
-            Message_rect.w = font->mSize * static_cast<int>(stringLen);
-            Message_rect.h = font->mSize + margin * 2;
-            break;
-        case Alignment::Right:
-            Message_rect.x = r.top.x + surfaceMessage->clip_rect.w - static_cast<int>(font->mSize) * static_cast<int>(stringLen);
-            Message_rect.y = r.top.y + margin;
-            Message_rect.w = font->mSize * static_cast<int>(stringLen);
-            Message_rect.h = font->mSize + margin * 2;
-            break;
-        case Alignment::Invalid:
-        case Alignment::Count:
-        default:
-            assert(false && "Not supported alignment.");
-            break;
-    }
-
-    SDL_RenderCopy(sdlCtx->mRenderer, messageTexture, nullptr, &Message_rect);
-    SDL_FreeSurface(surfaceMessage);
-    SDL_DestroyTexture(messageTexture);
+    const int32_t textWidth = atlas->measure(string, stringLen);
+    const Point2i pos = getTextPosition(ctx, r, textWidth, atlas->mLineHeight, alignment);
+    sdlCtx->mDrawBuffer.addText(*atlas, string, stringLen, pos.x, pos.y, textColor);
+    ctx.mFrameStats.mNumGlyphHits += stringLen;
 
     return ResultOk;
 }
@@ -315,8 +573,7 @@ ret_code Renderer::initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int
 
     const int32_t driverIndex = queryDriver(ctx, "opengl", 256);
     if (driverIndex == -1) {
-        ctx.mLogger(LogSeverity::Error, "Cannot open opengl driver");
-        return ErrorCode;
+        ctx.mLogger(LogSeverity::Warn, "Cannot open opengl driver, using the default driver.");
     }
 
     sdlCtx->mRenderer = SDL_CreateRenderer(sdlCtx->mWindow, driverIndex, SDL_RENDERER_ACCELERATED);
@@ -341,6 +598,52 @@ ret_code Renderer::initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int
     return ResultOk;
 }
 
+ret_code Renderer::initHeadlessScreen(Context &ctx, int32_t w, int32_t h) {
+    if (!ctx.mCreated) {
+        ctx.mLogger(LogSeverity::Error, "Not initialized.");
+        return ErrorCode;
+    }
+
+    if (w <= 0 || h <= 0) {
+        ctx.mLogger(LogSeverity::Error, "Invalid framebuffer size.");
+        return ErrorCode;
+    }
+
+    SDLContext *sdlCtx = SDLContext::create();
+    sdlCtx->mOwner = true;
+    sdlCtx->mHeadless = true;
+    ctx.mBackendCtx = new BackendContext;
+    ctx.mBackendCtx->mHandle = (void*) sdlCtx;
+
+    if (TTF_Init() == -1) {
+        ctx.mLogger(LogSeverity::Error, "TTF init failed.");
+        return ErrorCode;
+    }
+
+    if (loadDefaultFont(ctx) == nullptr) {
+        ctx.mLogger(LogSeverity::Error, "Cannot load default font.");
+        return ErrorCode;
+    }
+
+    sdlCtx->mSurface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+    if (sdlCtx->mSurface == nullptr) {
+        const std::string msg = "Error while creating the framebuffer: " + std::string(SDL_GetError()) + ".";
+        ctx.mLogger(LogSeverity::Error, msg.c_str());
+        return ErrorCode;
+    }
+
+    sdlCtx->mRenderer = SDL_CreateSoftwareRenderer(sdlCtx->mSurface);
+    if (sdlCtx->mRenderer == nullptr) {
+        const std::string msg = "Error while SDL_CreateSoftwareRenderer: " + std::string(SDL_GetError()) + ".";
+        ctx.mLogger(LogSeverity::Error, msg.c_str());
+        return ErrorCode;
+    }
+
+    showDriverInUse(ctx);
+
+    return ResultOk;
+}
+
 ret_code Renderer::initScreen(Context &ctx, SDL_Window *window, SDL_Renderer *renderer) {
     if (!ctx.mCreated) {
         ctx.mLogger(LogSeverity::Error, "TinyUI context is not initialzed.");
@@ -384,6 +687,15 @@ ret_code Renderer::releaseScreen(Context &ctx) {
     SDLContext *sdlCtx = getBackendContext(ctx);
     assert(sdlCtx != nullptr);
 
+    if (sdlCtx->mHeadless) {
+        // The framebuffer surface is owned by the headless screen
+        if (sdlCtx->mSurface != nullptr) {
+            SDL_FreeSurface(sdlCtx->mSurface);
+            sdlCtx->mSurface = nullptr;
+        }
+        return ResultOk;
+    }
+
     SDL_DestroyWindow(sdlCtx->mWindow);
     sdlCtx->mWindow = nullptr;
 
@@ -398,21 +710,45 @@ ret_code Renderer::beginRender(Context &ctx, Color4 bg, SDL_Texture *renderTarge
 
     const SDL_Color sdl_bg = getSDLColor(bg);
     SDLContext *sdlCtx = getBackendContext(ctx);
+    sdlCtx->mDrawBuffer.reset();
+    sdlCtx->mTextCache.beginFrame();
+
+    // The rects are drawn from the white block of the glyph atlas, so they share the batches with the text
+    loadDefaultFont(ctx);
+    Font *font = ctx.mDefaultFont;
+    if (font != nullptr && font->mFont->mFontImpl != nullptr) {
+        sdlCtx->mDrawBuffer.setSolidAtlas(getGlyphAtlas(ctx, sdlCtx, font));
+    }
+    sdlCtx->mFrameTargetActive = false;
+    if (renderTarget != nullptr) {
+        SDL_SetRenderTarget(sdlCtx->mRenderer, renderTarget);
+        SDL_RenderSetClipRect(sdlCtx->mRenderer, nullptr);
+        SDL_SetRenderDrawColor(sdlCtx->mRenderer, sdl_bg.r, sdl_bg.g, sdl_bg.b, sdl_bg.a);
+        SDL_RenderClear(sdlCtx->mRenderer);
+        return ResultOk;
+    }
+
+    // Only the damaged area gets redrawn into the retained frame, the rest is kept from the last frame
+    const bool retained = bindFrameTarget(ctx, sdlCtx);
     SDL_SetRenderDrawColor(sdlCtx->mRenderer, sdl_bg.r, sdl_bg.g, sdl_bg.b, sdl_bg.a);
-    SDL_RenderClear(sdlCtx->mRenderer);
+    if (retained && ctx.mDirtyRegion.isPartial()) {
+        const Rect &bounds = ctx.mDirtyRegion.mBounds;
+        const SDL_Rect clipRect = { bounds.top.x, bounds.top.y, bounds.width, bounds.height };
+        SDL_RenderSetClipRect(sdlCtx->mRenderer, &clipRect);
+        SDL_RenderFillRect(sdlCtx->mRenderer, &clipRect);
+    } else {
+        SDL_RenderSetClipRect(sdlCtx->mRenderer, nullptr);
+        SDL_RenderClear(sdlCtx->mRenderer);
+    }
 
     return ResultOk;
 }
 
 ret_code Renderer::drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) {
-    SDL_Rect r = {x, y, w, h};
+    const SDL_Rect r = {x, y, w, h};
     SDLContext *sdlCtx = getBackendContext(ctx);
-    SDL_SetRenderDrawColor(sdlCtx->mRenderer, fg.r, fg.g, fg.b, fg.a);
-    if (filled) {
-        SDL_RenderFillRect(sdlCtx->mRenderer, &r);
-    } else {
-        SDL_RenderDrawRect(sdlCtx->mRenderer, &r);
-    }
+    sdlCtx->mDrawBuffer.addRect(r, getSDLColor(fg), filled);
+    ++ctx.mFrameStats.mNumRects;
 
     return ResultOk;
 }
@@ -422,11 +758,33 @@ ret_code Renderer::drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int3
         return ErrorCode;
     }
 
-    SDL_Rect imageRect = {x, y, w, h};
+    SurfaceImpl *surfaceImpl = image->mSurfaceImpl;
+    if (surfaceImpl == nullptr) {
+        return ErrorCode;
+    }
+
     SDLContext *sdlCtx = getBackendContext(ctx);
-    SDL_Texture *tex = SDL_CreateTextureFromSurface(sdlCtx->mRenderer, image->mSurfaceImpl->mSurface);
-    SDL_RenderCopy(sdlCtx->mRenderer, tex, nullptr, &imageRect);
-    SDL_DestroyTexture(tex);
+    if (surfaceImpl->mTexture == nullptr) {
+        if (surfaceImpl->mSurface == nullptr) {
+            return ErrorCode;
+        }
+
+        surfaceImpl->mTexture = SDL_CreateTextureFromSurface(sdlCtx->mRenderer, surfaceImpl->mSurface);
+        if (surfaceImpl->mTexture == nullptr) {
+            TINYUI_LOG(ctx, LogSeverity::Error, "Cannot create image texture: %s.", SDL_GetError());
+            return ErrorCode;
+        }
+
+        ++ctx.mFrameStats.mNumTexturesCreated;
+        ++ctx.mFrameStats.mNumTextureUploads;
+        if (!ctx.mKeepImageData) {
+            surfaceImpl->releasePixels();
+        }
+    }
+
+    const SDL_Rect imageRect = {x, y, w, h};
+    sdlCtx->mDrawBuffer.addImage(surfaceImpl->mTexture, imageRect);
+    ++ctx.mFrameStats.mNumImages;
 
     return ResultOk;
 }
@@ -447,6 +805,14 @@ ret_code Renderer::closeScreen(Context &ctx) {
 
 ret_code Renderer::endRender(Context &ctx) {
     SDLContext *sdlCtx = getBackendContext(ctx);
+    ctx.mFrameStats.mNumDrawCalls += sdlCtx->mDrawBuffer.flush(sdlCtx->mRenderer);
+    if (sdlCtx->mFrameTargetActive) {
+        SDL_RenderSetClipRect(sdlCtx->mRenderer, nullptr);
+        SDL_SetRenderTarget(sdlCtx->mRenderer, nullptr);
+        SDL_RenderCopy(sdlCtx->mRenderer, sdlCtx->mFrameTarget, nullptr, nullptr);
+        ++ctx.mFrameStats.mNumDrawCalls;
+        sdlCtx->mFrameTargetActive = false;
+    }
     SDL_RenderPresent(sdlCtx->mRenderer);
 
     return ResultOk;
@@ -458,55 +824,34 @@ ret_code Renderer::createRenderTexture(Context &ctx, int w, int h, SDL_Texture *
     }
     SDLContext *sdlCtx = getBackendContext(ctx);
     *texture = SDL_CreateTexture(sdlCtx->mRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (*texture != nullptr) {
+        ++ctx.mFrameStats.mNumTexturesCreated;
+    }
 
     return ResultOk;
 }
 
-bool Renderer::update(const Context &ctx) {
+bool Renderer::update(Context &ctx) {
     if (!ctx.mCreated) { 
         return false;
     }
 
     bool running = !ctx.mRequestShutdown;
     SDL_Event event;
-    while (IODevice::update(event)) {
-        switch (event.type) {
-            case SDL_QUIT:
-                running = false;
-                break;
-
-            case SDL_MOUSEBUTTONDOWN:
-            case SDL_MOUSEBUTTONUP:
-                {
-                    const int32_t x = event.button.x;
-                    const int32_t y = event.button.y;
-                    Widgets::onMouseButton(x, y, getEventType(event.type), getButtonState(event.button));
-                } break;
-
-            case SDL_MOUSEMOTION:
-                {
-                    const int32_t x = event.button.x;
-                    const int32_t y = event.button.y;
-                } break;
+    MouseMotion motion;
+    if (ctx.mWaitForEvents && running) {
+        // Sleep until the next event, a wake-up or the next update is due
+        if (IODevice::waitEvent(event, getIdleTimeout(ctx))) {
+            running = handleEvent(ctx, event, motion) && running;
+        }
+    }
 
-            case SDL_KEYDOWN:
-                {
-                    const char *key = SDL_GetKeyName(event.key.keysym.sym);
-                    if (key == nullptr) {
-                        break;
-                    }
-                    Widgets::onKey(key, true);
-                } break;
+    while (IODevice::update(event)) {
+        running = handleEvent(ctx, event, motion) && running;
+    }
 
-            case SDL_KEYUP: 
-                {
-                    const char *key = SDL_GetKeyName(event.key.keysym.sym);
-                    if (key == nullptr) {
-                        break;
-                    }
-                    Widgets::onKey(key, false);
-                } break;
-        }
+    if (motion.mMoved) {
+        Widgets::onMouseMove(motion.mX, motion.mY, Events::MouseMoveEvent, motion.mState);
     }
 
     return running;
@@ -533,6 +878,7 @@ SurfaceImpl *Renderer::createSurfaceImpl(unsigned char *data, int w, int h, int
     }
     auto *surfaceImpl = new SurfaceImpl;
     surfaceImpl->mSurface = surface;
+    surfaceImpl->mPixels = data;
 
     return surfaceImpl;
 }
@@ -544,8 +890,74 @@ void Renderer::releaseSurfaceImpl(SurfaceImpl *surfaceImpl) {
     }
 }
 
+ret_code Renderer::setClipRect(Context &ctx, const Rect *rect) {
+    if (ctx.mBackendCtx == nullptr) {
+        return ErrorCode;
+    }
+
+    // The draws are batched, so the clipping is applied while recording them
+    SDLContext *sdlCtx = getBackendContext(ctx);
+    if (rect == nullptr) {
+        sdlCtx->mDrawBuffer.setClipRect(nullptr);
+    } else {
+        const SDL_Rect clipRect = { rect->top.x, rect->top.y, rect->width, rect->height };
+        sdlCtx->mDrawBuffer.setClipRect(&clipRect);
+    }
+
+    return ResultOk;
+}
+
+ret_code Renderer::setTextCacheBudget(Context &ctx, size_t budget) {
+    if (ctx.mBackendCtx == nullptr) {
+        return ErrorCode;
+    }
+
+    getBackendContext(ctx)->mTextCache.setBudget(budget);
+
+    return ResultOk;
+}
+
+ret_code Renderer::getTextCacheStats(const Context &ctx, TextCacheStats &stats) {
+    if (ctx.mBackendCtx == nullptr) {
+        return ErrorCode;
+    }
+
+    const auto *sdlCtx = (const SDLContext *) ctx.mBackendCtx->mHandle;
+    sdlCtx->mTextCache.getStats(stats);
+
+    return ResultOk;
+}
+
+ret_code Renderer::getFramebuffer(const Context &ctx, Framebuffer &framebuffer) {
+    if (ctx.mBackendCtx == nullptr) {
+        return ErrorCode;
+    }
+
+    const auto *sdlCtx = (const SDLContext *) ctx.mBackendCtx->mHandle;
+    if (!sdlCtx->mHeadless || sdlCtx->mSurface == nullptr) {
+        return ErrorCode;
+    }
+
+    framebuffer.mPixels = static_cast<const uint8_t*>(sdlCtx->mSurface->pixels);
+    framebuffer.mWidth = sdlCtx->mSurface->w;
+    framebuffer.mHeight = sdlCtx->mSurface->h;
+    framebuffer.mPitch = sdlCtx->mSurface->pitch;
+
+    return ResultOk;
+}
+
 ret_code Renderer::getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) {
     const auto *sdlCtx = (const SDLContext *) ctx.mBackendCtx->mHandle;
+
+    // The window surface is queried once at init, the output size of the renderer follows a resize
+    int outW{ 0 };
+    int outH{ 0 };
+    if (sdlCtx->mRenderer != nullptr && SDL_GetRendererOutputSize(sdlCtx->mRenderer, &outW, &outH) == 0) {
+        w = outW;
+        h = outH;
+        return ResultOk;
+    }
+
     if (sdlCtx->mSurface == nullptr) {
         return ErrorCode;
     }
@@ -556,4 +968,85 @@ ret_code Renderer::getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) {
     return ResultOk;
 }
 
+SDL2RenderBackend::SDL2RenderBackend(bool headless) : mHeadless(headless) {
+    // empty
+}
+
+ret_code SDL2RenderBackend::initRenderer(Context &ctx) {
+    return Renderer::initRenderer(ctx, mHeadless);
+}
+
+ret_code SDL2RenderBackend::releaseRenderer(Context &ctx) {
+    return Renderer::releaseRenderer(ctx);
+}
+
+ret_code SDL2RenderBackend::initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h) {
+    if (mHeadless) {
+        return Renderer::initHeadlessScreen(ctx, w, h);
+    }
+
+    return Renderer::initScreen(ctx, x, y, w, h);
+}
+
+ret_code SDL2RenderBackend::releaseScreen(Context &ctx) {
+    return Renderer::releaseScreen(ctx);
+}
+
+ret_code SDL2RenderBackend::drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r,
+        const Color4 &fgC, const Color4 &bgC, Alignment alignment) {
+    return Renderer::drawText(ctx, string, maxLen, font, r, fgC, bgC, alignment);
+}
+
+ret_code SDL2RenderBackend::drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) {
+    return Renderer::drawRect(ctx, x, y, w, h, filled, fg);
+}
+
+ret_code SDL2RenderBackend::drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, Image *image) {
+    return Renderer::drawImage(ctx, x, y, w, h, image);
+}
+
+ret_code SDL2RenderBackend::beginRender(Context &ctx, Color4 bg) {
+    return Renderer::beginRender(ctx, bg);
+}
+
+ret_code SDL2RenderBackend::endRender(Context &ctx) {
+    return Renderer::endRender(ctx);
+}
+
+bool SDL2RenderBackend::update(Context &ctx) {
+    return Renderer::update(ctx);
+}
+
+SurfaceImpl *SDL2RenderBackend::createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch) {
+    return Renderer::createSurfaceImpl(data, w, h, bytesPerPixel, pitch);
+}
+
+void SDL2RenderBackend::releaseSurfaceImpl(SurfaceImpl *surfaceImpl) {
+    Renderer::releaseSurfaceImpl(surfaceImpl);
+}
+
+ret_code SDL2RenderBackend::getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) {
+    return Renderer::getSurfaceInfo(ctx, w, h);
+}
+
+ret_code SDL2RenderBackend::getFramebuffer(const Context &ctx, Framebuffer &framebuffer) {
+    return Renderer::getFramebuffer(ctx, framebuffer);
+}
+
+ret_code SDL2RenderBackend::setClipRect(Context &ctx, const Rect *rect) {
+    return Renderer::setClipRect(ctx, rect);
+}
+
+ret_code SDL2RenderBackend::setTextCacheBudget(Context &ctx, size_t budget) {
+    return Renderer::setTextCacheBudget(ctx, budget);
+}
+
+ret_code SDL2RenderBackend::getTextCacheStats(const Context &ctx, TextCacheStats &stats) {
+    return Renderer::getTextCacheStats(ctx, stats);
+}
+
+void SDL2RenderBackend::wakeUp() {
+    IODevice::wakeUp();
+}
+
 } // namespace tinyui
@@ -24,6 +24,10 @@ SOFTWARE.
 #pragma once
 
 #include "tinyui.h"
+#include "render_backend.h"
+#include "sdl2_glyph_atlas.h"
+#include "sdl2_text_cache.h"
+#include "sdl2_draw_buffer.h"
 
 #include <SDL.h>
 #include <SDL_ttf.h>
@@ -39,7 +43,9 @@ namespace tinyui {
    
 /// @brief The surface implementation using the SDL2 library.
 struct SurfaceImpl {
-    SDL_Surface *mSurface{nullptr};
+    SDL_Surface *mSurface{nullptr};     ///< The CPU-side surface.
+    SDL_Texture *mTexture{nullptr};     ///< The uploaded texture, created on the first draw.
+    unsigned char *mPixels{nullptr};    ///< The pixel data owned by the surface.
 
     SurfaceImpl() = default;
 
@@ -47,18 +53,35 @@ struct SurfaceImpl {
         clear();
     }
 
-    void clear() {
+    void releasePixels() {
         if (mSurface != nullptr) {
             SDL_FreeSurface(mSurface);
             mSurface = nullptr;
         }
+        if (mPixels != nullptr) {
+            stbi_image_free(mPixels);
+            mPixels = nullptr;
+        }
+    }
+
+    void clear() {
+        if (mTexture != nullptr) {
+            SDL_DestroyTexture(mTexture);
+            mTexture = nullptr;
+        }
+        releasePixels();
     }
 };
 
 struct FontImpl {
     TTF_Font *mFontImpl{nullptr};
+    GlyphAtlas *mAtlas{nullptr};
     
     void clear() {
+        if (mAtlas != nullptr) {
+            GlyphAtlas::destroy(mAtlas);
+            mAtlas = nullptr;
+        }
         if (mFontImpl != nullptr) {
             TTF_CloseFont(mFontImpl);
             mFontImpl = nullptr;
@@ -78,6 +101,11 @@ struct SDLContext {
     SDL_Surface *mSurface{ nullptr };   ///< The surface.
     SDL_Renderer *mRenderer{ nullptr }; ///< The renderer.
     bool mOwner{ false };               ///< The owner state.
+    bool mHeadless{ false };            ///< true if rendering into an in-memory framebuffer without a window.
+    DrawCommandBuffer mDrawBuffer;      ///< The recorded draw commands of the current frame.
+    SDL_Texture *mFrameTarget{nullptr}; ///< The retained frame, used for partial redraws.
+    bool mFrameTargetActive{false};     ///< true if the current frame renders into the retained frame.
+    TextCache mTextCache;               ///< The cache for text, which cannot be drawn from the glyph atlas.
 
     /// @brief Will create a new SDL context.
     /// @return The created SDL context.
@@ -108,10 +136,11 @@ inline SDLContext *getBackendContext(Context &ctx) {
 
 /// @brief The renderer implementation using the SDL2 library.
 struct Renderer {
-    static ret_code initRenderer(Context &ctx);
+    static ret_code initRenderer(Context &ctx, bool headless = false);
     static ret_code releaseRenderer(Context &ctx);
     static ret_code initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h);
     static ret_code initScreen(Context &ctx, SDL_Window *mWindow, SDL_Renderer *mRenderer);
+    static ret_code initHeadlessScreen(Context &ctx, int32_t w, int32_t h);
     static ret_code releaseScreen(Context &ctx);
     static ret_code drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r, const Color4 &fgC, const Color4 &bgC, Alignment alignment);
     static ret_code drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg);
@@ -120,10 +149,47 @@ struct Renderer {
     static ret_code endRender(Context &ctx);
     static ret_code createRenderTexture(Context &ctx, int w, int h, SDL_Texture **texture);
     static ret_code closeScreen(Context &ctx);
-    static bool update(const Context &ctx);
+    static bool update(Context &ctx);
     static SurfaceImpl *createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch);
     static void releaseSurfaceImpl(SurfaceImpl *surfaceImpl);
     static ret_code getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h);
+    static ret_code getFramebuffer(const Context &ctx, Framebuffer &framebuffer);
+    static ret_code setClipRect(Context &ctx, const Rect *rect);
+    static ret_code setTextCacheBudget(Context &ctx, size_t budget);
+    static ret_code getTextCacheStats(const Context &ctx, TextCacheStats &stats);
+};
+
+/// @brief The SDL2 render backend, will forward all calls to the renderer.
+struct SDL2RenderBackend final : RenderBackendI {
+    /// @brief The class constructor.
+    /// @param[in] headless true to render into an in-memory framebuffer without a window.
+    explicit SDL2RenderBackend(bool headless = false);
+
+    /// @brief The class destructor.
+    ~SDL2RenderBackend() override = default;
+
+    ret_code initRenderer(Context &ctx) override;
+    ret_code releaseRenderer(Context &ctx) override;
+    ret_code initScreen(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h) override;
+    ret_code releaseScreen(Context &ctx) override;
+    ret_code drawText(Context &ctx, const char *string, size_t maxLen, Font *font, const Rect &r,
+        const Color4 &fgC, const Color4 &bgC, Alignment alignment) override;
+    ret_code drawRect(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, bool filled, Color4 fg) override;
+    ret_code drawImage(Context &ctx, int32_t x, int32_t y, int32_t w, int32_t h, Image *image) override;
+    ret_code beginRender(Context &ctx, Color4 bg) override;
+    ret_code endRender(Context &ctx) override;
+    bool update(Context &ctx) override;
+    SurfaceImpl *createSurfaceImpl(unsigned char *data, int w, int h, int bytesPerPixel, int pitch) override;
+    void releaseSurfaceImpl(SurfaceImpl *surfaceImpl) override;
+    ret_code getSurfaceInfo(const Context &ctx, int32_t &w, int32_t &h) override;
+    ret_code getFramebuffer(const Context &ctx, Framebuffer &framebuffer) override;
+    ret_code setClipRect(Context &ctx, const Rect *rect) override;
+    ret_code setTextCacheBudget(Context &ctx, size_t budget) override;
+    ret_code getTextCacheStats(const Context &ctx, TextCacheStats &stats) override;
+    void wakeUp() override;
+
+private:
+    bool mHeadless;
 };
 
 } //  namespace tinyui
@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "sdl2_text_cache.h"
+
+#include <functional>
+#include <iterator>
+
+namespace tinyui {
+
+size_t TextCacheKeyHash::operator()(const TextCacheKey &key) const {
+    size_t hash = std::hash<std::string>()(key.mText);
+    hash ^= std::hash<const void*>()(key.mFont) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint64_t>()((static_cast<uint64_t>(key.mSize) << 32) | key.mColor) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+    return hash;
+}
+
+TextCache::~TextCache() {
+    clear();
+}
+
+void TextCache::beginFrame() {
+    ++mFrame;
+}
+
+const TextCacheEntry *TextCache::find(const TextCacheKey &key) {
+    auto it = mLookup.find(key);
+    if (it == mLookup.end()) {
+        ++mMisses;
+        return nullptr;
+    }
+
+    ++mHits;
+    mEntries.splice(mEntries.begin(), mEntries, it->second);
+    it->second->mLastFrame = mFrame;
+
+    return &(*it->second);
+}
+
+const TextCacheEntry *TextCache::insert(const TextCacheKey &key, SDL_Texture *texture, int32_t w, int32_t h) {
+    if (auto it = mLookup.find(key); it != mLookup.end()) {
+        erase(it->second);
+    }
+
+    const size_t bytes = static_cast<size_t>(w) * static_cast<size_t>(h) * 4;
+    evict(bytes);
+
+    TextCacheEntry entry;
+    entry.mKey = key;
+    entry.mTexture = texture;
+    entry.mWidth = w;
+    entry.mHeight = h;
+    entry.mBytes = bytes;
+    entry.mLastFrame = mFrame;
+    mEntries.push_front(std::move(entry));
+    mLookup[mEntries.front().mKey] = mEntries.begin();
+    mBytes += bytes;
+
+    return &mEntries.front();
+}
+
+void TextCache::setBudget(size_t budget) {
+    mBudget = budget;
+    evict(0);
+}
+
+void TextCache::getStats(TextCacheStats &stats) const {
+    stats.mHits = mHits;
+    stats.mMisses = mMisses;
+    stats.mEvictions = mEvictions;
+    stats.mNumEntries = mEntries.size();
+    stats.mBytes = mBytes;
+    stats.mBudget = mBudget;
+}
+
+void TextCache::clear() {
+    for (auto &entry : mEntries) {
+        if (entry.mTexture != nullptr) {
+            SDL_DestroyTexture(entry.mTexture);
+        }
+    }
+    mEntries.clear();
+    mLookup.clear();
+    mBytes = 0;
+}
+
+void TextCache::evict(size_t requiredBytes) {
+    while (!mEntries.empty() && mBytes + requiredBytes > mBudget) {
+        auto last = std::prev(mEntries.end());
+        if (last->mLastFrame == mFrame) {
+            // All remaining entries are still in use by the current frame
+            break;
+        }
+        erase(last);
+        ++mEvictions;
+    }
+}
+
+void TextCache::erase(std::list<TextCacheEntry>::iterator it) {
+    if (it->mTexture != nullptr) {
+        SDL_DestroyTexture(it->mTexture);
+    }
+    mBytes -= it->mBytes;
+    mLookup.erase(it->mKey);
+    mEntries.erase(it);
+}
+
+} // namespace tinyui
@@ -0,0 +1,125 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <SDL.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace tinyui {
+
+/// @brief The key to identify a rendered string.
+struct TextCacheKey {
+    std::string mText;              ///< The text.
+    const void *mFont{nullptr};     ///< The font implementation.
+    uint32_t    mSize{0};           ///< The font size.
+    uint32_t    mColor{0};          ///< The packed text color.
+
+    /// @brief Compares two keys.
+    /// @param[in] rhs The key to compare with.
+    /// @return true if both keys are equal.
+    bool operator == (const TextCacheKey &rhs) const {
+        return mFont == rhs.mFont && mSize == rhs.mSize && mColor == rhs.mColor && mText == rhs.mText;
+    }
+};
+
+/// @brief The hash function for the text cache key.
+struct TextCacheKeyHash {
+    size_t operator()(const TextCacheKey &key) const;
+};
+
+/// @brief A cached text texture.
+struct TextCacheEntry {
+    TextCacheKey mKey;                  ///< The key of the entry.
+    SDL_Texture *mTexture{nullptr};     ///< The rendered text texture.
+    int32_t      mWidth{0};             ///< The width of the texture.
+    int32_t      mHeight{0};            ///< The height of the texture.
+    size_t       mBytes{0};             ///< The estimated memory size of the texture.
+    uint64_t     mLastFrame{0};         ///< The frame the entry was used the last time.
+};
+
+/// @brief Stores rendered text textures across frames and evicts the least recently used ones.
+///
+/// The cache is used for all strings, which cannot be drawn by the glyph atlas. Entries of changed
+/// strings are not dropped explicitly, they are not used anymore and age out by the LRU order.
+struct TextCache {
+    /// The default memory budget in bytes.
+    static constexpr size_t DefaultBudget = 8 * 1024 * 1024;
+
+    /// @brief The class destructor.
+    ~TextCache();
+
+    /// @brief Will start a new frame.
+    ///
+    /// Entries used in the current frame are referenced by recorded draw commands and will
+    /// not be evicted before the next frame starts.
+    void beginFrame();
+
+    /// @brief Will look for a cached text texture and mark it as recently used.
+    /// @param[in] key The key to look for.
+    /// @return The entry or nullptr if not cached.
+    const TextCacheEntry *find(const TextCacheKey &key);
+
+    /// @brief Will insert a new text texture, the cache takes the ownership of the texture.
+    /// @param[in] key      The key of the text.
+    /// @param[in] texture  The rendered text texture.
+    /// @param[in] w        The width of the texture.
+    /// @param[in] h        The height of the texture.
+    /// @return The new entry.
+    const TextCacheEntry *insert(const TextCacheKey &key, SDL_Texture *texture, int32_t w, int32_t h);
+
+    /// @brief Will set the memory budget, entries will be evicted if required.
+    /// @param[in] budget The new budget in bytes.
+    void setBudget(size_t budget);
+
+    /// @brief Will return the statistics of the cache.
+    /// @param[out] stats The statistics.
+    void getStats(TextCacheStats &stats) const;
+
+    /// @brief Will release all cached textures.
+    void clear();
+
+private:
+    void evict(size_t requiredBytes);
+    void erase(std::list<TextCacheEntry>::iterator it);
+
+private:
+    using EntryList = std::list<TextCacheEntry>;
+    using EntryMap = std::unordered_map<TextCacheKey, EntryList::iterator, TextCacheKeyHash>;
+
+    EntryList   mEntries;                   ///< The entries, the most recently used one first.
+    EntryMap    mLookup;                    ///< The lookup from the key to the entry.
+    size_t      mBudget{DefaultBudget};     ///< The memory budget in bytes.
+    size_t      mBytes{0};                  ///< The used memory in bytes.
+    uint64_t    mHits{0};                   ///< The number of cache hits.
+    uint64_t    mMisses{0};                 ///< The number of cache misses.
+    uint64_t    mEvictions{0};              ///< The number of evicted entries.
+    uint64_t    mFrame{0};                  ///< The current frame.
+};
+
+} // namespace tinyui
@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "command_queue.h"
+
+#include <utility>
+
+namespace tinyui {
+
+WidgetCommand WidgetCommand::setText(WidgetHandle handle, const char *text) {
+    WidgetCommand command;
+    command.mType = CommandType::SetText;
+    command.mHandle = handle;
+    command.mText = text != nullptr ? text : "";
+
+    return command;
+}
+
+WidgetCommand WidgetCommand::setProgressValue(WidgetHandle handle, int32_t fillRate) {
+    WidgetCommand command;
+    command.mType = CommandType::SetProgressValue;
+    command.mHandle = handle;
+    command.mValue = fillRate;
+
+    return command;
+}
+
+WidgetCommand WidgetCommand::setEnableState(WidgetHandle handle, bool enabled) {
+    WidgetCommand command;
+    command.mType = CommandType::SetEnableState;
+    command.mHandle = handle;
+    command.mValue = enabled ? 1 : 0;
+
+    return command;
+}
+
+WidgetCommand WidgetCommand::setRect(WidgetHandle handle, const Rect &rect) {
+    WidgetCommand command;
+    command.mType = CommandType::SetRect;
+    command.mHandle = handle;
+    command.mRect = rect;
+
+    return command;
+}
+
+WidgetCommand WidgetCommand::invoke(std::function<void()> func) {
+    WidgetCommand command;
+    command.mType = CommandType::Invoke;
+    command.mFunc = std::move(func);
+
+    return command;
+}
+
+CommandQueue::CommandQueue() {
+    // The queue starts with a consumed stub node
+    auto *stub = new Node;
+    mHead.store(stub, std::memory_order_relaxed);
+    mTail = stub;
+}
+
+CommandQueue::~CommandQueue() {
+    Node *node = mTail;
+    while (node != nullptr) {
+        Node *next = node->mNext.load(std::memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+void CommandQueue::push(WidgetCommand &&command) {
+    auto *node = new Node;
+    node->mCommand = std::move(command);
+
+    // Link the node after the previous head, the consumer will see it once mNext is published
+    Node *prev = mHead.exchange(node, std::memory_order_acq_rel);
+    prev->mNext.store(node, std::memory_order_release);
+}
+
+bool CommandQueue::pop(WidgetCommand &command) {
+    Node *tail = mTail;
+    Node *next = tail->mNext.load(std::memory_order_acquire);
+    if (next == nullptr) {
+        return false;
+    }
+
+    // The next node becomes the new consumed stub
+    command = std::move(next->mCommand);
+    mTail = next;
+    delete tail;
+
+    return true;
+}
+
+void CommandQueue::setWakeUpEnabled(bool enabled) {
+    mWakeUpEnabled.store(enabled, std::memory_order_release);
+}
+
+bool CommandQueue::markWakeUp() {
+    if (!mWakeUpEnabled.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    return !mWakePending.exchange(true, std::memory_order_acq_rel);
+}
+
+void CommandQueue::clearWakeUp() {
+    // The exchange pairs with the one in markWakeUp, so the commands pushed before it are visible to the drain
+    mWakePending.exchange(false, std::memory_order_acq_rel);
+}
+
+} // namespace tinyui
@@ -0,0 +1,133 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+
+namespace tinyui {
+
+/// @brief The type of a widget command.
+enum class CommandType : int32_t {
+    Invalid = -1,       ///< Not initialized
+    SetText,            ///< Set the text of a widget
+    SetProgressValue,   ///< Set the value of a progress bar
+    SetEnableState,     ///< Enable or disable a widget
+    SetRect,            ///< Set the rectangle of a widget
+    Invoke,             ///< Call a function on the ui thread, for instance to create a subtree
+    Count               ///< The number of command types
+};
+
+/// @brief A command to change widgets, which can be posted from any thread.
+struct WidgetCommand {
+    CommandType           mType{CommandType::Invalid};  ///< The command type.
+    WidgetHandle          mHandle{};                    ///< The widget to change.
+    std::string           mText{};                      ///< The text for SetText.
+    int32_t               mValue{0};                    ///< The value for SetProgressValue and SetEnableState.
+    Rect                  mRect{};                      ///< The rectangle for SetRect.
+    std::function<void()> mFunc{};                      ///< The function for Invoke.
+
+    /// @brief Will create a command to set the text of a widget.
+    /// @param[in] handle The widget handle.
+    /// @param[in] text   The new text.
+    /// @return The command.
+    static WidgetCommand setText(WidgetHandle handle, const char *text);
+
+    /// @brief Will create a command to set the value of a progress bar.
+    /// @param[in] handle   The widget handle.
+    /// @param[in] fillRate The new fill rate in percent.
+    /// @return The command.
+    static WidgetCommand setProgressValue(WidgetHandle handle, int32_t fillRate);
+
+    /// @brief Will create a command to enable or disable a widget.
+    /// @param[in] handle  The widget handle.
+    /// @param[in] enabled The new enabled state.
+    /// @return The command.
+    static WidgetCommand setEnableState(WidgetHandle handle, bool enabled);
+
+    /// @brief Will create a command to set the rectangle of a widget.
+    /// @param[in] handle The widget handle.
+    /// @param[in] rect   The new rectangle relative to the parent.
+    /// @return The command.
+    static WidgetCommand setRect(WidgetHandle handle, const Rect &rect);
+
+    /// @brief Will create a command to call a function on the ui thread.
+    /// @param[in] func The function to call.
+    /// @return The command.
+    static WidgetCommand invoke(std::function<void()> func);
+};
+
+/// @brief A lock-free multiple-producer single-consumer queue for widget commands.
+///
+/// Any thread can push commands, only the ui thread is allowed to pop them. Pushing is
+/// wait-free, it is one atomic exchange per command. The pending wake-up flag makes sure,
+/// that only the first command pushed since the last drain wakes up the ui thread.
+struct CommandQueue {
+    /// @brief The default class constructor.
+    CommandQueue();
+
+    /// @brief The class destructor, will release all pending commands.
+    ~CommandQueue();
+
+    // Disable copy and assignment
+    CommandQueue(const CommandQueue &) = delete;
+    CommandQueue &operator=(const CommandQueue &) = delete;
+
+    /// @brief Will add a command, can be called from any thread.
+    /// @param[in] command The command to add.
+    void push(WidgetCommand &&command);
+
+    /// @brief Will remove the oldest command, must only be called from the ui thread.
+    /// @param[out] command The removed command.
+    /// @return true if a command was removed, false if the queue is empty.
+    bool pop(WidgetCommand &command);
+
+    /// @brief Will enable the wake-ups for pushed commands, only needed in the idle mode.
+    /// @param[in] enabled true to enable the wake-ups.
+    void setWakeUpEnabled(bool enabled);
+
+    /// @brief Will mark a wake-up as pending, can be called from any thread.
+    /// @return true if the ui thread needs to be woken up, false if the wake-ups are disabled
+    ///         or a wake-up is already pending.
+    bool markWakeUp();
+
+    /// @brief Will clear the pending wake-up, must be called by the ui thread before draining the queue.
+    void clearWakeUp();
+
+private:
+    struct Node {
+        std::atomic<Node*> mNext{nullptr};  ///< The next node.
+        WidgetCommand      mCommand;        ///< The command.
+    };
+
+    std::atomic<Node*> mHead;               ///< The last pushed node, written by the producers.
+    Node              *mTail;               ///< The consumer side, always points to a consumed node.
+    std::atomic<bool>  mWakeUpEnabled{false};   ///< true if pushed commands shall wake up the ui thread.
+    std::atomic<bool>  mWakePending{false};     ///< true if a wake-up was sent and not handled yet.
+};
+
+} // namespace tinyui
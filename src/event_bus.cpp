@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "event_bus.h"
+
+#include <algorithm>
+
+namespace tinyui {
+
+namespace {
+
+    // The lower bits of a token store the event id, the upper ones a serial number
+    constexpr uint32_t EventIdBits = 8;
+    constexpr SubscriptionToken EventIdMask = (1u << EventIdBits) - 1;
+
+    static_assert(Events::NumEvents <= (1 << EventIdBits), "Too many events for the token layout.");
+
+} // namespace
+
+SubscriptionToken EventBus::subscribe(int32_t eventId, EventListener listener, void *instance) {
+    if (eventId < 0 || eventId >= Events::NumEvents || listener == nullptr) {
+        return InvalidToken;
+    }
+
+    const SubscriptionToken token = (mNextSerial++ << EventIdBits) | static_cast<SubscriptionToken>(eventId);
+    mSubscribers[eventId].push_back({ token, listener, instance });
+
+    return token;
+}
+
+bool EventBus::unsubscribe(SubscriptionToken token) {
+    const auto eventId = static_cast<int32_t>(token & EventIdMask);
+    if (token == InvalidToken || eventId >= Events::NumEvents) {
+        return false;
+    }
+
+    auto &subscribers = mSubscribers[eventId];
+    for (size_t i = 0; i < subscribers.size(); ++i) {
+        if (subscribers[i].mToken != token || subscribers[i].mListener == nullptr) {
+            continue;
+        }
+
+        if (mDispatching) {
+            // The array is in use, the entry will be removed after the dispatch
+            subscribers[i].mListener = nullptr;
+            mNeedsCompaction = true;
+        } else {
+            subscribers.erase(subscribers.begin() + i);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void EventBus::post(const Event &event) {
+    if (event.mId < 0 || event.mId >= Events::NumEvents) {
+        return;
+    }
+
+    // There is no need to queue events nobody is listening to
+    if (mSubscribers[event.mId].empty()) {
+        return;
+    }
+    mQueue.push_back(event);
+}
+
+size_t EventBus::dispatch() {
+    if (mQueue.empty() || mDispatching) {
+        return 0;
+    }
+
+    mBatch.swap(mQueue);
+    mDispatching = true;
+    for (const Event &event : mBatch) {
+        // Listeners may subscribe while dispatching, so the array is accessed by index
+        const auto &subscribers = mSubscribers[event.mId];
+        for (size_t i = 0; i < subscribers.size(); ++i) {
+            const Subscriber subscriber = subscribers[i];
+            if (subscriber.mListener != nullptr) {
+                subscriber.mListener(event, subscriber.mInstance);
+            }
+        }
+    }
+    mDispatching = false;
+
+    const size_t numEvents = mBatch.size();
+    mBatch.clear();
+    if (mNeedsCompaction) {
+        compact();
+    }
+
+    return numEvents;
+}
+
+size_t EventBus::getNumListeners(int32_t eventId) const {
+    if (eventId < 0 || eventId >= Events::NumEvents) {
+        return 0;
+    }
+
+    const auto &subscribers = mSubscribers[eventId];
+    return static_cast<size_t>(std::count_if(subscribers.begin(), subscribers.end(),
+        [](const Subscriber &subscriber) { return subscriber.mListener != nullptr; }));
+}
+
+void EventBus::compact() {
+    for (auto &subscribers : mSubscribers) {
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+            [](const Subscriber &subscriber) { return subscriber.mListener == nullptr; }), subscribers.end());
+    }
+    mNeedsCompaction = false;
+}
+
+} // namespace tinyui
@@ -0,0 +1,90 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <vector>
+
+namespace tinyui {
+
+/// @brief The event bus for global listeners like key shortcuts, telemetry or logging.
+///
+/// Each event id has its own contiguous subscriber array. Events get queued while the input
+/// is processed and will be dispatched to the listeners as one batch per frame.
+struct EventBus {
+    static constexpr SubscriptionToken InvalidToken = 0;    ///< The invalid token.
+
+    /// @brief Will add a listener for an event.
+    /// @param[in] eventId  The event id.
+    /// @param[in] listener The listener function.
+    /// @param[in] instance The instance passed to the listener.
+    /// @return The token of the subscription or InvalidToken in case of an error.
+    SubscriptionToken subscribe(int32_t eventId, EventListener listener, void *instance);
+
+    /// @brief Will remove a listener, can be called from a listener.
+    /// @param[in] token The token of the subscription.
+    /// @return true if the listener was removed, false if the token is unknown.
+    bool unsubscribe(SubscriptionToken token);
+
+    /// @brief Will queue an event for the next dispatch.
+    /// @param[in] event The event.
+    void post(const Event &event);
+
+    /// @brief Will dispatch all queued events.
+    ///
+    /// Events posted by the listeners will be dispatched with the next batch.
+    /// @return The number of dispatched events.
+    size_t dispatch();
+
+    /// @brief Will return the number of queued events.
+    /// @return The number of events.
+    size_t getNumPending() const {
+        return mQueue.size();
+    }
+
+    /// @brief Will return the number of listeners for an event.
+    /// @param[in] eventId The event id.
+    /// @return The number of listeners.
+    size_t getNumListeners(int32_t eventId) const;
+
+private:
+    void compact();
+
+private:
+    struct Subscriber {
+        SubscriptionToken mToken{InvalidToken};     ///< The subscription token.
+        EventListener     mListener{nullptr};       ///< The listener, nullptr if removed while dispatching.
+        void             *mInstance{nullptr};       ///< The listener instance.
+    };
+
+    std::vector<Subscriber> mSubscribers[Events::NumEvents];    ///< The subscribers per event id.
+    std::vector<Event>      mQueue;                             ///< The queued events.
+    std::vector<Event>      mBatch;                             ///< The events in dispatch.
+    SubscriptionToken       mNextSerial{1};                     ///< The serial number for the next token.
+    bool                    mDispatching{false};                ///< true while dispatching.
+    bool                    mNeedsCompaction{false};            ///< true if listeners were removed while dispatching.
+};
+
+} // namespace tinyui
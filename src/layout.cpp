@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "layout.h"
+
+#include <algorithm>
+
+namespace tinyui {
+
+namespace {
+
+    LayoutNode *getValidNode(Context &ctx, Widget *widget) {
+        if (widget->mLayout == nullptr) {
+            widget->mLayout = ctx.mWidgetPool->mLayouts.create();
+            widget->mLayout->mWidth = widget->mRect.width;
+            widget->mLayout->mHeight = widget->mRect.height;
+        }
+
+        return widget->mLayout;
+    }
+
+    bool isRelativeChild(const Widget *child) {
+        return child->mLayoutPolicy == LayoutPolicy::Relative && child->mLayout != nullptr;
+    }
+
+    bool fillsViewport(const Context &ctx, const Widget *widget) {
+        return widget->mParent == ctx.mRoot && widget->mLayout->mFlex > 0;
+    }
+
+    void measure(Widget *widget) {
+        LayoutNode &node = *widget->mLayout;
+        if (!node.mDirty) {
+            return;
+        }
+
+        int32_t w = 0;
+        int32_t h = 0;
+        if (node.isContainer()) {
+            const bool horizontal = node.mDirection == LayoutDirection::Horizontal;
+            int32_t main = 0;
+            int32_t cross = 0;
+            int32_t numChildren = 0;
+            for (Widget *child : widget->mChildren) {
+                if (!isRelativeChild(child)) {
+                    continue;
+                }
+
+                measure(child);
+                const LayoutNode &childNode = *child->mLayout;
+                main += horizontal ? childNode.mMeasuredWidth : childNode.mMeasuredHeight;
+                cross = std::max(cross, horizontal ? childNode.mMeasuredHeight : childNode.mMeasuredWidth);
+                ++numChildren;
+            }
+            if (numChildren > 0) {
+                main += (numChildren - 1) * node.mSpacing;
+            }
+            main += 2 * node.mPadding;
+            cross += 2 * node.mPadding;
+            w = horizontal ? main : cross;
+            h = horizontal ? cross : main;
+        }
+
+        node.mMeasuredWidth = std::max(node.mWidth, w);
+        node.mMeasuredHeight = std::max(node.mHeight, h);
+    }
+
+    void arrange(Context &ctx, Widget *widget, const Rect &rect) {
+        // The rect is relative to the origin of the parent
+        LayoutNode &node = *widget->mLayout;
+        Rect &current = widget->mRect;
+        const bool moved = current.top.x != rect.top.x || current.top.y != rect.top.y;
+        const bool resized = current.width != rect.width || current.height != rect.height;
+        if (moved && widget->mParent != nullptr) {
+            // The children follow their parent, a clean subtree does not need to be arranged again
+            Widgets::setPosition(widget->mHandle, rect.top.x, rect.top.y);
+        }
+        if (!node.mDirty && !resized) {
+            return;
+        }
+
+        if (resized) {
+            ctx.mDirtyRegion.add(widget->getScreenRect());
+            current.set(current.top.x, current.top.y, rect.width, rect.height);
+            if (ctx.mWidgetTree != nullptr) {
+                ctx.mWidgetTree->sync(widget);
+            }
+            ctx.mDirtyRegion.add(widget->getScreenRect());
+        }
+        node.mDirty = false;
+        if (!node.isContainer()) {
+            return;
+        }
+
+        const bool horizontal = node.mDirection == LayoutDirection::Horizontal;
+        const int32_t innerMain = (horizontal ? rect.width : rect.height) - 2 * node.mPadding;
+        const int32_t innerCross = (horizontal ? rect.height : rect.width) - 2 * node.mPadding;
+
+        // Distribute the remaining space by the flex values
+        int32_t used = 0;
+        int32_t totalFlex = 0;
+        int32_t numChildren = 0;
+        for (const Widget *child : widget->mChildren) {
+            if (isRelativeChild(child)) {
+                used += horizontal ? child->mLayout->mMeasuredWidth : child->mLayout->mMeasuredHeight;
+                totalFlex += child->mLayout->mFlex;
+                ++numChildren;
+            }
+        }
+        if (numChildren > 0) {
+            used += (numChildren - 1) * node.mSpacing;
+        }
+        const int32_t remaining = std::max(0, innerMain - used);
+
+        // The children of the root are placed in screen coordinates
+        const Vec2i base = widget->mParent == nullptr ? rect.top : Vec2i(0, 0);
+        int32_t pos = (horizontal ? base.x : base.y) + node.mPadding;
+        int32_t distributed = 0;
+        int32_t flexSum = 0;
+        for (Widget *child : widget->mChildren) {
+            if (!isRelativeChild(child)) {
+                continue;
+            }
+
+            const LayoutNode &childNode = *child->mLayout;
+            int32_t size = horizontal ? childNode.mMeasuredWidth : childNode.mMeasuredHeight;
+            if (totalFlex > 0 && childNode.mFlex > 0) {
+                // Computed from the running sum, so the rounding errors do not add up
+                flexSum += childNode.mFlex;
+                const int32_t share = static_cast<int32_t>(static_cast<int64_t>(remaining) * flexSum / totalFlex);
+                size += share - distributed;
+                distributed = share;
+            }
+
+            const Rect childRect = horizontal ?
+                Rect(pos, base.y + node.mPadding, size, innerCross) :
+                Rect(base.x + node.mPadding, pos, innerCross, size);
+            arrange(ctx, child, childRect);
+            pos += size + node.mSpacing;
+        }
+    }
+
+} // namespace
+
+ret_code Layout::setContainer(WidgetHandle id, LayoutDirection direction, int32_t spacing, int32_t padding) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = Widgets::findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    if (direction == LayoutDirection::Invalid || direction == LayoutDirection::Count) {
+        return ErrorCode;
+    }
+
+    LayoutNode *node = getValidNode(ctx, widget);
+    node->mDirection = direction;
+    node->mSpacing = spacing;
+    node->mPadding = padding;
+    for (Widget *child : widget->mChildren) {
+        attach(ctx, child);
+    }
+    invalidate(ctx, widget);
+
+    return ResultOk;
+}
+
+ret_code Layout::setItem(WidgetHandle id, int32_t width, int32_t height, int32_t flex) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = Widgets::findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    LayoutNode *node = getValidNode(ctx, widget);
+    node->mWidth = width;
+    node->mHeight = height;
+    node->mFlex = flex;
+    invalidate(ctx, widget);
+
+    return ResultOk;
+}
+
+void Layout::setViewport(Context &ctx, const Rect &viewport) {
+    ctx.mViewport = viewport;
+    if (ctx.mRoot == nullptr) {
+        return;
+    }
+
+    for (Widget *child : ctx.mRoot->mChildren) {
+        if (child->mLayout != nullptr && fillsViewport(ctx, child)) {
+            invalidate(ctx, child);
+        }
+    }
+}
+
+void Layout::update(Context &ctx) {
+    if (ctx.mDirtyLayouts.empty()) {
+        return;
+    }
+
+    for (const WidgetHandle &handle : ctx.mDirtyLayouts) {
+        Widget *widget = Widgets::findWidget(handle, ctx.mRoot);
+        if (widget == nullptr || widget->mLayout == nullptr || !widget->mLayout->mDirty) {
+            continue;
+        }
+
+        measure(widget);
+        const LayoutNode &node = *widget->mLayout;
+        Rect rect = widget->mRect;
+        if (fillsViewport(ctx, widget)) {
+            rect = ctx.mViewport;
+        } else {
+            rect.set(rect.top.x, rect.top.y, node.mMeasuredWidth, node.mMeasuredHeight);
+        }
+        arrange(ctx, widget, rect);
+    }
+    ctx.mDirtyLayouts.clear();
+}
+
+void Layout::invalidate(Context &ctx, Widget *widget) {
+    while (widget != nullptr && widget->mLayout != nullptr) {
+        if (widget->mLayout->mDirty) {
+            return;
+        }
+
+        widget->mLayout->mDirty = true;
+        Widget *parent = widget->mParent;
+        if (widget->mLayoutPolicy != LayoutPolicy::Relative || parent == nullptr || parent->mLayout == nullptr) {
+            // This is the layout root
+            ctx.mDirtyLayouts.push_back(widget->mHandle);
+            return;
+        }
+        widget = parent;
+    }
+}
+
+void Layout::attach(Context &ctx, Widget *widget) {
+    getValidNode(ctx, widget);
+    widget->mLayoutPolicy = LayoutPolicy::Relative;
+    invalidate(ctx, widget);
+}
+
+} // namespace tinyui
@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "widgets.h"
+
+namespace tinyui {
+
+/// @brief The layout engine for stack and flex containers.
+///
+/// A container stacks its relative children along its direction. Each child gets its measured
+/// size along the main axis plus its flex share of the remaining space, and the full inner size
+/// along the cross axis. Changing a child marks the path up to its layout root as dirty, only
+/// dirty subtrees and subtrees with a changed rect will be measured and arranged again.
+/// Measurements are cached in the layout nodes between frames.
+struct Layout {
+    /// @brief Will turn a widget into a layout container, all children become relative.
+    /// @param[in] id        The widget id.
+    /// @param[in] direction The stack direction.
+    /// @param[in] spacing   The space between two children.
+    /// @param[in] padding   The space between the border and the children.
+    /// @return ResultOk if successful, InvalidHandle for an unknown widget, ErrorCode otherwise.
+    static ret_code setContainer(WidgetHandle id, LayoutDirection direction, int32_t spacing, int32_t padding);
+
+    /// @brief Will set the layout parameters of a widget.
+    ///
+    /// A container on the top level with a flex value greater than 0 fills the viewport.
+    /// @param[in] id     The widget id.
+    /// @param[in] width  The preferred width.
+    /// @param[in] height The preferred height.
+    /// @param[in] flex   The share of the remaining space along the main axis of the parent.
+    /// @return ResultOk if successful, InvalidHandle for an unknown widget.
+    static ret_code setItem(WidgetHandle id, int32_t width, int32_t height, int32_t flex);
+
+    /// @brief Will set the visible area, top level containers filling it will be updated.
+    /// @param[in] ctx      The context.
+    /// @param[in] viewport The new viewport.
+    static void setViewport(Context &ctx, const Rect &viewport);
+
+    /// @brief Will measure and arrange all dirty layouts.
+    /// @param[in] ctx The context.
+    static void update(Context &ctx);
+
+    /// @brief Will mark the layout of a widget and all parents up to the layout root as dirty.
+    /// @param[in] ctx    The context.
+    /// @param[in] widget The widget.
+    static void invalidate(Context &ctx, Widget *widget);
+
+    /// @brief Will attach a new widget to the layout of its parent container.
+    /// @param[in] ctx    The context.
+    /// @param[in] widget The new widget.
+    static void attach(Context &ctx, Widget *widget);
+};
+
+} // namespace tinyui
@@ -0,0 +1,284 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace tinyui {
+
+namespace {
+
+    constexpr char const *SeverityToken[] = {
+        "",
+        "*TRACE*",
+        "*DEBUG*",
+        "*INFO* ",
+        "*WARN* ",
+        "*ERROR*"
+    };
+
+    constexpr size_t RecordMask = Logger::NumRecords - 1;
+    constexpr size_t NumRateEntries = 64;
+
+    /// A queued message. The sequence is the ring position while the record is free and
+    /// the position + 1 when the message is ready to be written.
+    struct LogRecord {
+        std::atomic<size_t> mSeq{0};
+        LogSeverity         mSeverity{LogSeverity::Message};
+        char                mText[Logger::MaxMessageLength]{};
+    };
+
+    /// The rate limit state of the messages with the same hash.
+    struct RateEntry {
+        std::atomic<uint64_t> mHash{0};
+        std::atomic<uint32_t> mWindowStart{0};
+        std::atomic<uint32_t> mCount{0};
+        std::atomic<uint32_t> mSuppressed{0};
+    };
+
+    struct LogQueue {
+        LogRecord                mRecords[Logger::NumRecords];
+        RateEntry                mRates[NumRateEntries];
+        std::atomic<size_t>      mTail{0};
+        std::atomic<size_t>      mHead{0};
+        std::atomic<bool>        mWaiting{false};
+        std::atomic<bool>        mStop{false};
+        std::atomic<LogSeverity> mMinSeverity{LogSeverity::Message};
+        std::atomic<uint64_t>    mNumWritten{0};
+        std::atomic<uint64_t>    mNumDropped{0};
+        std::atomic<uint64_t>    mNumSuppressed{0};
+        std::mutex               mMutex;
+        std::condition_variable  mWakeUp;
+        std::thread              mThread;
+
+        LogQueue() {
+            for (size_t i = 0; i < Logger::NumRecords; ++i) {
+                mRecords[i].mSeq.store(i, std::memory_order_relaxed);
+            }
+            mThread = std::thread([this]() {
+                run();
+            });
+        }
+
+        ~LogQueue() {
+            mStop.store(true);
+            mWakeUp.notify_one();
+            mThread.join();
+        }
+
+        bool push(LogSeverity severity, const char *message, uint32_t numSuppressed) {
+            size_t pos = mTail.load(std::memory_order_relaxed);
+            LogRecord *record = nullptr;
+            for (;;) {
+                record = &mRecords[pos & RecordMask];
+                const size_t seq = record->mSeq.load(std::memory_order_acquire);
+                const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;   // The ring is full
+                } else {
+                    pos = mTail.load(std::memory_order_relaxed);
+                }
+            }
+
+            record->mSeverity = severity;
+            if (numSuppressed == 0) {
+                snprintf(record->mText, sizeof(record->mText), "%s", message);
+            } else {
+                snprintf(record->mText, sizeof(record->mText), "%s (%u repeated messages suppressed)", message, numSuppressed);
+            }
+            record->mSeq.store(pos + 1, std::memory_order_release);
+            if (mWaiting.load(std::memory_order_relaxed)) {
+                mWakeUp.notify_one();
+            }
+
+            return true;
+        }
+
+        /// Will write all queued records with one write call, returns false if the ring was empty.
+        bool drain(std::string &buffer) {
+            buffer.clear();
+            size_t pos = mHead.load(std::memory_order_relaxed);
+            for (;;) {
+                LogRecord &record = mRecords[pos & RecordMask];
+                if (record.mSeq.load(std::memory_order_acquire) != pos + 1) {
+                    break;
+                }
+
+                const auto severity = static_cast<size_t>(std::to_underlying(record.mSeverity));
+                if (record.mSeverity != LogSeverity::Message && severity < std::size(SeverityToken)) {
+                    buffer.append(SeverityToken[severity]);
+                    buffer.push_back(' ');
+                }
+                buffer.append(record.mText);
+                buffer.push_back('\n');
+                record.mSeq.store(pos + Logger::NumRecords, std::memory_order_release);
+                ++pos;
+                mNumWritten.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (buffer.empty()) {
+                return false;
+            }
+
+            fwrite(buffer.data(), 1, buffer.size(), stdout);
+            fflush(stdout);
+            mHead.store(pos, std::memory_order_release);
+
+            return true;
+        }
+
+        void run() {
+            std::string buffer;
+            buffer.reserve(Logger::NumRecords * 16);
+            for (;;) {
+                if (drain(buffer)) {
+                    continue;
+                }
+                if (mStop.load()) {
+                    break;
+                }
+
+                // The timeout covers a notification sent between the last drain and the wait
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWaiting.store(true);
+                mWakeUp.wait_for(lock, std::chrono::milliseconds(50));
+                mWaiting.store(false);
+            }
+        }
+
+        /// Returns false if the message exceeds the rate limit, the suppressed copies since the last window are returned.
+        bool checkRate(LogSeverity severity, const char *message, uint32_t &numSuppressed) {
+            // FNV-1a over the severity and the text
+            uint64_t hash = 14695981039346656037ull ^ static_cast<uint64_t>(std::to_underlying(severity));
+            for (const char *c = message; *c != '\0'; ++c) {
+                hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+            }
+            hash |= 1; // 0 marks an unused entry
+
+            const auto now = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+            RateEntry &entry = mRates[hash % NumRateEntries];
+            numSuppressed = 0;
+            if (entry.mHash.load(std::memory_order_relaxed) != hash || now - entry.mWindowStart.load(std::memory_order_relaxed) >= Logger::RateLimitWindow) {
+                if (entry.mHash.exchange(hash, std::memory_order_relaxed) == hash) {
+                    numSuppressed = entry.mSuppressed.exchange(0, std::memory_order_relaxed);
+                } else {
+                    entry.mSuppressed.store(0, std::memory_order_relaxed);
+                }
+                entry.mWindowStart.store(now, std::memory_order_relaxed);
+                entry.mCount.store(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            if (entry.mCount.fetch_add(1, std::memory_order_relaxed) < Logger::MaxRepeats) {
+                return true;
+            }
+            entry.mSuppressed.fetch_add(1, std::memory_order_relaxed);
+            mNumSuppressed.fetch_add(1, std::memory_order_relaxed);
+
+            return false;
+        }
+    };
+
+    LogQueue &getQueue() {
+        static LogQueue queue;
+        return queue;
+    }
+
+} // namespace
+
+bool Logger::isEnabled(LogSeverity severity) {
+    return isCompiledIn(severity) && severity >= getQueue().mMinSeverity.load(std::memory_order_relaxed);
+}
+
+bool Logger::log(LogSeverity severity, const char *message) {
+    if (message == nullptr || !isEnabled(severity)) {
+        return false;
+    }
+
+    LogQueue &queue = getQueue();
+    uint32_t numSuppressed = 0;
+    if (!queue.checkRate(severity, message, numSuppressed)) {
+        return false;
+    }
+    if (!queue.push(severity, message, numSuppressed)) {
+        queue.mNumDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void Logger::setMinSeverity(LogSeverity severity) {
+    getQueue().mMinSeverity.store(severity, std::memory_order_relaxed);
+}
+
+LogSeverity Logger::getMinSeverity() {
+    return getQueue().mMinSeverity.load(std::memory_order_relaxed);
+}
+
+void Logger::flush() {
+    LogQueue &queue = getQueue();
+    const size_t tail = queue.mTail.load(std::memory_order_acquire);
+    while (queue.mHead.load(std::memory_order_acquire) < tail) {
+        queue.mWakeUp.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+LogStats Logger::getStats() {
+    const LogQueue &queue = getQueue();
+    LogStats stats;
+    stats.mNumWritten = queue.mNumWritten.load(std::memory_order_relaxed);
+    stats.mNumDropped = queue.mNumDropped.load(std::memory_order_relaxed);
+    stats.mNumSuppressed = queue.mNumSuppressed.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void log_format(const Context &ctx, LogSeverity severity, const char *format, ...) {
+    if (format == nullptr || ctx.mLogger == nullptr || !Logger::isEnabled(severity)) {
+        return;
+    }
+
+    char message[Logger::MaxMessageLength];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    ctx.mLogger(severity, message);
+}
+
+} // namespace tinyui
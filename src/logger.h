@@ -0,0 +1,105 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#ifndef TINYUI_LOG_MIN_SEVERITY
+#  define TINYUI_LOG_MIN_SEVERITY 0
+#endif
+
+namespace tinyui {
+
+/// @brief The counters of the logger.
+struct LogStats {
+    uint64_t mNumWritten{0};        ///< The number of written messages.
+    uint64_t mNumDropped{0};        ///< The number of messages dropped as the queue was full.
+    uint64_t mNumSuppressed{0};     ///< The number of repeated messages dropped by the rate limit.
+};
+
+/// @brief The asynchronous logger.
+///
+/// The messages are copied into fixed-size records of a lock-free ring buffer, a background
+/// thread writes them to stdout. Logging never blocks the caller: when the ring is full, the
+/// message gets dropped and counted. A message repeated more than MaxRepeats times within one
+/// RateLimitWindow will be suppressed, the number of suppressed copies is appended to the next
+/// one which gets through.
+struct Logger {
+    static constexpr size_t   NumRecords = 1024;        ///< The capacity of the ring, a power of two.
+    static constexpr size_t   MaxMessageLength = 240;   ///< The longest message, longer ones get truncated.
+    static constexpr uint32_t RateLimitWindow = 1000;   ///< The rate limit window in ms.
+    static constexpr uint32_t MaxRepeats = 5;           ///< The number of equal messages per window.
+
+    /// @brief Will return true, if messages with the severity are compiled in.
+    /// @param[in] severity The severity.
+    /// @return true if the severity is not filtered by TINYUI_LOG_MIN_SEVERITY.
+    static constexpr bool isCompiledIn(LogSeverity severity) {
+        return static_cast<int>(severity) >= TINYUI_LOG_MIN_SEVERITY;
+    }
+
+    /// @brief Will return true, if messages with the severity will be written.
+    /// @param[in] severity The severity.
+    /// @return true if the severity passes the compile-time and the runtime filter.
+    static bool isEnabled(LogSeverity severity);
+
+    /// @brief Will queue a message, can be called from any thread.
+    /// @param[in] severity The severity.
+    /// @param[in] message  The message.
+    /// @return true if the message was queued, false if it was filtered or dropped.
+    static bool log(LogSeverity severity, const char *message);
+
+    /// @brief Will set the lowest severity to write.
+    /// @param[in] severity The lowest severity.
+    static void setMinSeverity(LogSeverity severity);
+
+    /// @brief Will return the lowest severity to write.
+    /// @return The lowest severity.
+    static LogSeverity getMinSeverity();
+
+    /// @brief Will block until all queued messages are written.
+    static void flush();
+
+    /// @brief Will return the counters of the logger.
+    /// @return The counters.
+    static LogStats getStats();
+};
+
+/// @brief Will format a message and pass it to the logger of the context.
+///
+/// The message is formatted into a stack buffer after the severity filter, so filtered
+/// messages cost no formatting and no allocation. Use the TINYUI_LOG macro to remove
+/// filtered severities at compile time.
+/// @param[in] ctx      The context.
+/// @param[in] severity The severity.
+/// @param[in] format   The printf-style format.
+void log_format(const Context &ctx, LogSeverity severity, const char *format, ...);
+
+#define TINYUI_LOG(ctx, severity, ...)                                  \
+    do {                                                                \
+        if constexpr (tinyui::Logger::isCompiledIn(severity)) {        \
+            tinyui::log_format(ctx, severity, __VA_ARGS__);             \
+        }                                                               \
+    } while (false)
+
+} // namespace tinyui
@@ -0,0 +1,194 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace tinyui {
+
+namespace {
+
+    constexpr uint64_t SampleMask = Profiler::NumSamples - 1;
+
+    /// A slot of the sample ring, guarded by a sequence number. The sequence is 0 while the
+    /// slot gets written and the ring position + 1 when the sample is complete.
+    struct SampleSlot {
+        std::atomic<uint64_t>    mSeq{0};
+        std::atomic<const char*> mName{nullptr};
+        std::atomic<uint64_t>    mStart{0};
+        std::atomic<uint64_t>    mEnd{0};
+        std::atomic<uint32_t>    mThread{0};
+    };
+
+    SampleSlot Samples[Profiler::NumSamples];
+    std::atomic<uint64_t> SampleHead{0};
+    std::atomic<uint32_t> NumThreads{0};
+
+    // Only written by the UI thread
+    uint64_t FrameTimes[Profiler::NumFrames] = {};
+    uint64_t NumFrameTimes = 0;
+    uint64_t LastFrameStart = 0;
+
+    uint32_t getThreadIndex() {
+        thread_local const uint32_t index = NumThreads.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    uint64_t getPercentile(const std::vector<uint64_t> &sorted, uint32_t percent) {
+        // Nearest rank
+        const size_t rank = (sorted.size() * percent + 99) / 100;
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+} // namespace
+
+uint64_t Profiler::now() {
+    const auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+void Profiler::record(const char *name, uint64_t start, uint64_t end) {
+    const uint64_t pos = SampleHead.fetch_add(1, std::memory_order_relaxed);
+    SampleSlot &slot = Samples[pos & SampleMask];
+    slot.mSeq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.mName.store(name, std::memory_order_relaxed);
+    slot.mStart.store(start, std::memory_order_relaxed);
+    slot.mEnd.store(end, std::memory_order_relaxed);
+    slot.mThread.store(getThreadIndex(), std::memory_order_relaxed);
+    slot.mSeq.store(pos + 1, std::memory_order_release);
+}
+
+void Profiler::beginFrame() {
+    const uint64_t start = now();
+    if (LastFrameStart != 0) {
+        FrameTimes[NumFrameTimes % NumFrames] = start - LastFrameStart;
+        ++NumFrameTimes;
+        record("frame", LastFrameStart, start);
+    }
+    LastFrameStart = start;
+}
+
+ret_code Profiler::getFrameTimeStats(FrameTimeStats &stats) {
+    stats = FrameTimeStats{};
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(NumFrameTimes, NumFrames));
+    if (count == 0) {
+        return ErrorCode;
+    }
+
+    std::vector<uint64_t> frameTimes(FrameTimes, FrameTimes + count);
+
+    return computeFrameTimeStats(frameTimes, stats);
+}
+
+ret_code Profiler::computeFrameTimeStats(std::vector<uint64_t> &frameTimes, FrameTimeStats &stats) {
+    stats = FrameTimeStats{};
+    if (frameTimes.empty()) {
+        return ErrorCode;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    stats.mNumFrames = frameTimes.size();
+    stats.mMin = frameTimes.front();
+    stats.mMax = frameTimes.back();
+    stats.mP50 = getPercentile(frameTimes, 50);
+    stats.mP95 = getPercentile(frameTimes, 95);
+    stats.mP99 = getPercentile(frameTimes, 99);
+
+    return ResultOk;
+}
+
+size_t Profiler::getSamples(std::vector<ProfileSample> &samples) {
+    samples.clear();
+    const uint64_t head = SampleHead.load(std::memory_order_acquire);
+    const uint64_t first = head > NumSamples ? head - NumSamples : 0;
+    samples.reserve(static_cast<size_t>(head - first));
+    for (uint64_t pos = first; pos < head; ++pos) {
+        const SampleSlot &slot = Samples[pos & SampleMask];
+        if (slot.mSeq.load(std::memory_order_acquire) != pos + 1) {
+            continue;   // Still written or already overwritten
+        }
+
+        ProfileSample sample;
+        sample.mName = slot.mName.load(std::memory_order_relaxed);
+        sample.mStart = slot.mStart.load(std::memory_order_relaxed);
+        sample.mEnd = slot.mEnd.load(std::memory_order_relaxed);
+        sample.mThread = slot.mThread.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.mSeq.load(std::memory_order_relaxed) == pos + 1) {
+            samples.push_back(sample);
+        }
+    }
+
+    return samples.size();
+}
+
+ret_code Profiler::exportChromeTrace(const char *filename) {
+    if (filename == nullptr) {
+        return ErrorCode;
+    }
+
+    std::vector<ProfileSample> samples;
+    getSamples(samples);
+
+    FILE *file = fopen(filename, "w");
+    if (file == nullptr) {
+        return ErrorCode;
+    }
+
+    uint64_t base = UINT64_MAX;
+    for (const auto &sample : samples) {
+        base = std::min(base, sample.mStart);
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const ProfileSample &sample = samples[i];
+        const uint64_t ts = sample.mStart - base;
+        const uint64_t dur = sample.mEnd - sample.mStart;
+        fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"tinyui\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu}",
+            i == 0 ? "" : ",", sample.mName, sample.mThread,
+            static_cast<unsigned long long>(ts / 1000), static_cast<unsigned long long>(ts % 1000),
+            static_cast<unsigned long long>(dur / 1000), static_cast<unsigned long long>(dur % 1000));
+    }
+    fprintf(file, "\n]}\n");
+    const bool ok = ferror(file) == 0;
+    fclose(file);
+
+    return ok ? ResultOk : ErrorCode;
+}
+
+void Profiler::reset() {
+    for (auto &slot : Samples) {
+        slot.mSeq.store(0, std::memory_order_relaxed);
+    }
+    SampleHead.store(0, std::memory_order_release);
+    NumFrameTimes = 0;
+    LastFrameStart = 0;
+}
+
+} // namespace tinyui
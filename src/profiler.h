@@ -0,0 +1,115 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+namespace tinyui {
+
+/// @brief A recorded profiler scope.
+struct ProfileSample {
+    const char *mName{nullptr};     ///< The scope name, must be a string literal.
+    uint64_t    mStart{0};          ///< The start time in ns.
+    uint64_t    mEnd{0};            ///< The end time in ns.
+    uint32_t    mThread{0};         ///< The index of the recording thread.
+};
+
+/// @brief The frame profiler.
+///
+/// The samples are stored in a fixed-size ring buffer. Any thread can record samples without
+/// taking a lock, the oldest samples will be overwritten when the buffer is full. The frame
+/// times are measured between two calls of beginFrame and must be recorded by the UI thread.
+struct Profiler {
+    static constexpr size_t NumSamples = 1u << 14;  ///< The capacity of the sample ring, a power of two.
+    static constexpr size_t NumFrames = 1u << 10;   ///< The number of frame times kept for the statistics.
+
+    /// @brief Will return the current time of the monotonic clock.
+    /// @return The time in ns.
+    static uint64_t now();
+
+    /// @brief Will record a finished scope.
+    /// @param[in] name     The scope name, must be a string literal.
+    /// @param[in] start    The start time in ns.
+    /// @param[in] end      The end time in ns.
+    static void record(const char *name, uint64_t start, uint64_t end);
+
+    /// @brief Will mark the begin of a new frame, the time since the last call is the frame time.
+    static void beginFrame();
+
+    /// @brief Will return the percentiles of the recorded frame times.
+    /// @param[out] stats   The frame time statistics.
+    /// @return ResultOk if frames were recorded, ErrorCode if not.
+    static ret_code getFrameTimeStats(FrameTimeStats &stats);
+
+    /// @brief Will compute the percentiles of a list of frame times.
+    /// @param[in,out] frameTimes  The frame times in ns, will be sorted.
+    /// @param[out]    stats       The frame time statistics.
+    /// @return ResultOk if the list was not empty, ErrorCode if it was.
+    static ret_code computeFrameTimeStats(std::vector<uint64_t> &frameTimes, FrameTimeStats &stats);
+
+    /// @brief Will copy the recorded samples, the oldest first.
+    /// @param[out] samples The samples.
+    /// @return The number of samples.
+    static size_t getSamples(std::vector<ProfileSample> &samples);
+
+    /// @brief Will write the recorded samples as Chrome trace-event JSON.
+    /// @param[in] filename The name of the trace file.
+    /// @return ResultOk if the file was written, ErrorCode if not.
+    static ret_code exportChromeTrace(const char *filename);
+
+    /// @brief Will drop all samples and frame times.
+    static void reset();
+};
+
+/// @brief Records the lifetime of the scope, use the TINYUI_PROFILE_SCOPE macro.
+struct ProfileScope {
+    /// @brief The class constructor.
+    /// @param[in] name The scope name, must be a string literal.
+    explicit ProfileScope(const char *name) : mName(name), mStart(Profiler::now()) {}
+
+    /// @brief The class destructor, will record the sample.
+    ~ProfileScope() {
+        Profiler::record(mName, mStart, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *mName;
+    uint64_t    mStart;
+};
+
+#define TINYUI_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TINYUI_PROFILE_CONCAT(a, b) TINYUI_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef TINYUI_PROFILE_ENABLED
+#  define TINYUI_PROFILE_SCOPE(name) tinyui::ProfileScope TINYUI_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#  define TINYUI_PROFILE_FRAME() tinyui::Profiler::beginFrame()
+#else
+#  define TINYUI_PROFILE_SCOPE(name)
+#  define TINYUI_PROFILE_FRAME()
+#endif
+
+} // namespace tinyui
@@ -0,0 +1,295 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace tinyui {
+
+namespace {
+
+    constexpr uint64_t SlotMask = TimerWheel::NumSlots - 1;
+
+    uint32_t getLevel(uint64_t diff) {
+        uint32_t level = 0;
+        while (level + 1 < TimerWheel::NumLevels && diff >= (1ull << (TimerWheel::SlotBits * (level + 1)))) {
+            ++level;
+        }
+        return level;
+    }
+
+} // namespace
+
+TimerWheel::TimerWheel() {
+    std::fill(std::begin(mSlots), std::end(mSlots), InvalidIndex);
+    std::fill(std::begin(mLevelCount), std::end(mLevelCount), 0u);
+}
+
+TimerId TimerWheel::add(uint32_t now, uint32_t delayMs, uint32_t periodMs, TimerCallback callback, void *instance) {
+    if (callback == nullptr) {
+        return InvalidId;
+    }
+    sync(now);
+
+    uint32_t index = mFreeList;
+    if (index != InvalidIndex) {
+        mFreeList = mTimers[index].mNext;
+    } else {
+        index = static_cast<uint32_t>(mTimers.size());
+        mTimers.emplace_back();
+        mTimers[index].mGeneration = 1;
+    }
+
+    Timer &timer = mTimers[index];
+    timer.mExpires = std::max(toTick(now) + std::min(delayMs, MaxDelay), mTime + 1);
+    timer.mPeriod = std::min(periodMs, MaxDelay);
+    timer.mState = TimerState::Pending;
+    timer.mCallback = callback;
+    timer.mInstance = instance;
+    insert(index);
+    ++mNumActive;
+
+    return (static_cast<TimerId>(timer.mGeneration) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    const auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    const auto generation = static_cast<uint32_t>(id >> 32);
+    if (id == InvalidId || index >= mTimers.size() || mTimers[index].mGeneration != generation) {
+        return false;
+    }
+
+    Timer &timer = mTimers[index];
+    switch (timer.mState) {
+        case TimerState::Pending:
+            unlink(index);
+            release(index);
+            break;
+        case TimerState::Due:
+            // The timer is fired right now, it will be released by advance()
+            timer.mState = TimerState::Canceled;
+            break;
+        default:
+            return false;
+    }
+    --mNumActive;
+
+    return true;
+}
+
+size_t TimerWheel::advance(uint32_t now) {
+    if (!mStarted) {
+        sync(now);
+        return 0;
+    }
+
+    const uint64_t target = toTick(now);
+    size_t numFired = 0;
+    while (mTime < target) {
+        if (mNumActive == 0) {
+            mTime = target;
+            break;
+        }
+
+        const uint64_t tick = mTime + 1;
+        if ((tick & SlotMask) == 0) {
+            // Move the timers of the higher levels down, starting with the highest one
+            for (uint32_t level = NumLevels - 1; level > 0; --level) {
+                const uint64_t mask = (1ull << (SlotBits * level)) - 1;
+                if ((tick & mask) == 0) {
+                    cascade(level, tick);
+                }
+            }
+        }
+
+        const uint32_t slot = static_cast<uint32_t>(tick & SlotMask);
+        for (uint32_t index = mSlots[slot]; index != InvalidIndex; index = mTimers[index].mNext) {
+            mTimers[index].mState = TimerState::Due;
+            mTimers[index].mSlot = InvalidIndex;
+            mDue.push_back(index);
+            --mLevelCount[0];
+        }
+        mSlots[slot] = InvalidIndex;
+        mTime = tick;
+
+        // The callbacks may add timers, so the storage is accessed by index
+        for (const uint32_t index : mDue) {
+            if (mTimers[index].mState == TimerState::Due) {
+                mTimers[index].mCallback((static_cast<TimerId>(mTimers[index].mGeneration) << 32) | index, mTimers[index].mInstance);
+                ++numFired;
+            }
+
+            Timer &timer = mTimers[index];
+            if (timer.mState == TimerState::Canceled) {
+                release(index);
+            } else if (timer.mState == TimerState::Due) {
+                if (timer.mPeriod == 0) {
+                    release(index);
+                    --mNumActive;
+                } else {
+                    timer.mExpires = std::max(timer.mExpires + timer.mPeriod, mTime + 1);
+                    timer.mState = TimerState::Pending;
+                    insert(index);
+                }
+            }
+        }
+        mDue.clear();
+
+        // Without timers in the first level nothing can happen until the next cascade
+        if (mLevelCount[0] == 0) {
+            mTime = std::min(target, mTime | SlotMask);
+        }
+    }
+    mLastNow = now;
+
+    return numFired;
+}
+
+uint32_t TimerWheel::getNextTimeout(uint32_t now) const {
+    if (mNumActive == 0) {
+        return NoTimeout;
+    }
+
+    const uint64_t tick = mTime + 1;
+    uint64_t next = ~0ull;
+    if (mLevelCount[0] != 0) {
+        for (uint64_t i = 0; i < NumSlots; ++i) {
+            if (mSlots[(tick + i) & SlotMask] != InvalidIndex) {
+                next = tick + i;
+                break;
+            }
+        }
+    }
+
+    // Timers of the higher levels need attention when their slot gets cascaded
+    for (uint32_t level = 1; level < NumLevels; ++level) {
+        if (mLevelCount[level] == 0) {
+            continue;
+        }
+
+        const uint32_t shift = SlotBits * level;
+        const uint64_t first = ((tick + (1ull << shift) - 1) >> shift) << shift;
+        for (uint64_t i = 0; i < NumSlots; ++i) {
+            const uint64_t cascadeTick = first + (i << shift);
+            if (mSlots[level * NumSlots + ((cascadeTick >> shift) & SlotMask)] != InvalidIndex) {
+                next = std::min(next, cascadeTick);
+                break;
+            }
+        }
+    }
+
+    const uint64_t current = toTick(now);
+    if (next <= current) {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(std::min<uint64_t>(next - current, NoTimeout - 1));
+}
+
+void TimerWheel::clear() {
+    for (uint32_t i = 0; i < mTimers.size(); ++i) {
+        if (mTimers[i].mState != TimerState::Free) {
+            release(i);
+        }
+    }
+    std::fill(std::begin(mSlots), std::end(mSlots), InvalidIndex);
+    std::fill(std::begin(mLevelCount), std::end(mLevelCount), 0u);
+    mNumActive = 0;
+}
+
+uint64_t TimerWheel::toTick(uint32_t now) const {
+    // The unsigned difference handles the wrap around of the 32 bit ticks
+    return mTime + static_cast<uint32_t>(now - mLastNow);
+}
+
+void TimerWheel::sync(uint32_t now) {
+    if (!mStarted) {
+        mStarted = true;
+        mTime = now;
+        mLastNow = now;
+    }
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Timer &timer = mTimers[index];
+    const uint64_t tick = mTime + 1;
+    if (timer.mExpires - tick > MaxDelay) {
+        timer.mExpires = tick + MaxDelay;
+    }
+
+    const uint32_t level = getLevel(timer.mExpires - tick);
+    const uint32_t slot = level * NumSlots + static_cast<uint32_t>((timer.mExpires >> (SlotBits * level)) & SlotMask);
+    timer.mPrev = InvalidIndex;
+    timer.mNext = mSlots[slot];
+    timer.mSlot = slot;
+    if (timer.mNext != InvalidIndex) {
+        mTimers[timer.mNext].mPrev = index;
+    }
+    mSlots[slot] = index;
+    ++mLevelCount[level];
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer &timer = mTimers[index];
+    if (timer.mPrev != InvalidIndex) {
+        mTimers[timer.mPrev].mNext = timer.mNext;
+    } else {
+        mSlots[timer.mSlot] = timer.mNext;
+    }
+    if (timer.mNext != InvalidIndex) {
+        mTimers[timer.mNext].mPrev = timer.mPrev;
+    }
+    --mLevelCount[timer.mSlot / NumSlots];
+    timer.mSlot = InvalidIndex;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer &timer = mTimers[index];
+    timer.mState = TimerState::Free;
+    timer.mCallback = nullptr;
+    timer.mInstance = nullptr;
+    timer.mSlot = InvalidIndex;
+    timer.mPrev = InvalidIndex;
+    timer.mNext = mFreeList;
+
+    // Outdated ids must not match the next timer stored in this entry
+    if (++timer.mGeneration == 0) {
+        timer.mGeneration = 1;
+    }
+    mFreeList = index;
+}
+
+void TimerWheel::cascade(uint32_t level, uint64_t tick) {
+    const uint32_t slot = level * NumSlots + static_cast<uint32_t>((tick >> (SlotBits * level)) & SlotMask);
+    uint32_t index = mSlots[slot];
+    mSlots[slot] = InvalidIndex;
+    while (index != InvalidIndex) {
+        const uint32_t next = mTimers[index].mNext;
+        --mLevelCount[level];
+        insert(index);
+        index = next;
+    }
+}
+
+} // namespace tinyui
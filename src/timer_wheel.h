@@ -0,0 +1,127 @@
+/*
+MIT License
+
+Copyright (c) 2022-2026 Kim Kulling
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "tinyui.h"
+
+#include <vector>
+
+namespace tinyui {
+
+/// @brief A hierarchical timer wheel with a resolution of one millisecond.
+///
+/// The wheel uses four levels with 256 slots each. The first level stores the timers due
+/// in the next 256 ms, the higher levels store the later ones and will be cascaded down when
+/// the lower level wraps around. Adding, canceling and firing a timer costs O(1), a frame
+/// without due timers only checks the slots of the elapsed milliseconds.
+struct TimerWheel {
+    static constexpr uint32_t SlotBits = 8;                             ///< The bits of the slot index per level.
+    static constexpr uint32_t NumSlots = 1u << SlotBits;                ///< The number of slots per level.
+    static constexpr uint32_t NumLevels = 4;                            ///< The number of levels.
+    static constexpr uint32_t MaxDelay = 0xFFFFFFFFu - (1u << 24);      ///< The longest supported delay in ms.
+    static constexpr uint32_t NoTimeout = 0xFFFFFFFFu;                  ///< No timer is pending.
+    static constexpr TimerId  InvalidId = 0;                            ///< The invalid timer id.
+
+    /// @brief The class constructor.
+    TimerWheel();
+
+    /// @brief Will add a new timer.
+    /// @param[in] now      The current ticks in ms.
+    /// @param[in] delayMs  The delay until the first call in ms.
+    /// @param[in] periodMs The period in ms for repeating timers, 0 for one-shot timers.
+    /// @param[in] callback The callback to call.
+    /// @param[in] instance The instance passed to the callback.
+    /// @return The id of the timer, InvalidId in case of an error.
+    TimerId add(uint32_t now, uint32_t delayMs, uint32_t periodMs, TimerCallback callback, void *instance);
+
+    /// @brief Will cancel a timer, can be called from within a timer callback.
+    /// @param[in] id The timer id.
+    /// @return true if the timer was canceled, false if the timer is unknown or expired.
+    bool cancel(TimerId id);
+
+    /// @brief Will fire all timers which are due.
+    /// @param[in] now The current ticks in ms.
+    /// @return The number of fired timers.
+    size_t advance(uint32_t now);
+
+    /// @brief Will return the time until the next timer needs attention.
+    ///
+    /// For timers in the higher levels the time until they get cascaded will be returned, so
+    /// the result is never later than the real deadline.
+    /// @param[in] now The current ticks in ms.
+    /// @return The timeout in ms, NoTimeout if no timer is pending.
+    uint32_t getNextTimeout(uint32_t now) const;
+
+    /// @brief Will return the number of pending timers.
+    /// @return The number of timers.
+    size_t size() const {
+        return mNumActive;
+    }
+
+    /// @brief Will remove all timers.
+    void clear();
+
+private:
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    enum class TimerState : uint8_t {
+        Free,       ///< The entry is unused.
+        Pending,    ///< The timer is stored in a slot.
+        Due,        ///< The timer gets fired.
+        Canceled    ///< The timer was canceled while being due.
+    };
+
+    struct Timer {
+        uint64_t      mExpires{0};              ///< The tick to fire.
+        uint32_t      mPeriod{0};               ///< The period, 0 for one-shot timers.
+        uint32_t      mGeneration{0};           ///< The generation of the entry.
+        uint32_t      mNext{InvalidIndex};      ///< The next timer in the slot or in the free list.
+        uint32_t      mPrev{InvalidIndex};      ///< The previous timer in the slot.
+        uint32_t      mSlot{InvalidIndex};      ///< The slot the timer is stored in.
+        TimerState    mState{TimerState::Free}; ///< The state.
+        TimerCallback mCallback{nullptr};       ///< The callback.
+        void         *mInstance{nullptr};       ///< The callback instance.
+    };
+
+    uint64_t toTick(uint32_t now) const;
+    void sync(uint32_t now);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(uint32_t level, uint64_t tick);
+
+private:
+    std::vector<Timer>    mTimers;                          ///< The timer storage.
+    std::vector<uint32_t> mDue;                             ///< The timers which are fired right now.
+    uint32_t              mSlots[NumLevels * NumSlots];     ///< The first timer per slot.
+    uint32_t              mLevelCount[NumLevels];           ///< The number of timers per level.
+    uint32_t              mFreeList{InvalidIndex};          ///< The first unused timer entry.
+    size_t                mNumActive{0};                    ///< The number of pending timers.
+    uint64_t              mTime{0};                         ///< The last processed tick.
+    uint32_t              mLastNow{0};                      ///< The ticks in ms matching mTime.
+    bool                  mStarted{false};                  ///< true if the time base was set.
+
+};
+
+} // namespace tinyui
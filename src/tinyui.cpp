@@ -23,10 +23,17 @@ SOFTWARE.
 */
 #include "tinyui.h"
 #include "widgets.h"
+#include "command_queue.h"
+#include "event_bus.h"
+#include "timer_wheel.h"
+#include "layout.h"
+#include "profiler.h"
+#include "logger.h"
+#include "backends/render_backend.h"
 #include "backends/sdl2_renderer.h"
 #include "backends/sdl2_iodevice.h"
+#include "backends/sdl2_event_recorder.h"
 
-#include <iostream>
 #include <utility>
 
 namespace tinyui {
@@ -41,27 +48,67 @@ static Style DefaultStyle {
     { "Arial.ttf", 10, nullptr }
 };
 
-static constexpr char const *SeverityToken[] = {
-    "",
-    "*TRACE*",
-    "*DEBUG*",
-    "*INFO* ",
-    "*WARN* ",
-    "*ERROR*"
-};
+static ret_code initBackend(Context &ctx, RenderBackendI *backend, int32_t x, int32_t y, int32_t w, int32_t h) {
+    assert(backend != nullptr);
+    if (ctx.mBackend != nullptr) {
+        ctx.mLogger(LogSeverity::Error, "Screen already initialized.");
+        delete backend;
+        return ErrorCode;
+    }
+
+    ctx.mBackend = backend;
+    if (backend->initRenderer(ctx) == ErrorCode) {
+        ctx.mLogger(LogSeverity::Error, "Cannot init renderer");
+        delete backend;
+        ctx.mBackend = nullptr;
+        return ErrorCode;
+    }
+
+    ctx.mViewport = Rect(0, 0, w, h);
+
+    return backend->initScreen(ctx, x, y, w, h);
+}
+
+static void executeCommand(WidgetCommand &command) {
+    switch (command.mType) {
+        case CommandType::SetText:
+            Widgets::setText(command.mHandle, command.mText.c_str());
+            break;
+        case CommandType::SetProgressValue:
+            Widgets::setProgressValue(command.mHandle, command.mValue);
+            break;
+        case CommandType::SetEnableState:
+            Widgets::setEnableState(command.mHandle, command.mValue != 0);
+            break;
+        case CommandType::SetRect:
+            Widgets::setRect(command.mHandle, command.mRect);
+            break;
+        case CommandType::Invoke:
+            if (command.mFunc) {
+                command.mFunc();
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void processCommands(Context &ctx) {
+    // A command pushed while draining marks a new wake-up, so it is never left behind
+    ctx.mCommandQueue->clearWakeUp();
+    WidgetCommand command;
+    while (ctx.mCommandQueue->pop(command)) {
+        executeCommand(command);
+    }
+}
 
 static void logVersion(const Context &ctx) {
-    const std::string msg ="TinyUI Version: " + std::to_string(ctx.mVersion.major) + "." + std::to_string(ctx.mVersion.minor) + "." + std::to_string(ctx.mVersion.patch);
-    ctx.mLogger(LogSeverity::Info, msg.c_str());
+    TINYUI_LOG(ctx, LogSeverity::Info, "TinyUI Version: %u.%u.%u", ctx.mVersion.major, ctx.mVersion.minor, ctx.mVersion.patch);
 }
 
 void log_message(LogSeverity severity, const char *message) {
     assert(message != nullptr);
-    if (severity == LogSeverity::Message) {
-        std::cout << message << "\n";
-    } else {
-        std::cout << SeverityToken[std::to_underlying(severity)] << " " << message << "\n";
-    }
+    Logger::log(severity, message);
 }
 
 Context *gCtx = nullptr;
@@ -72,6 +119,9 @@ Context *Context::create(const char *title, const Style &style) {
     ctx->mAppTitle = title;
     ctx->mWindowsTitle = title;
     ctx->mStyle = style;
+    ctx->mCommandQueue = new CommandQueue;
+    ctx->mEventBus = new EventBus;
+    ctx->mTimers = new TimerWheel;
 
     logVersion(*ctx);
 
@@ -79,6 +129,18 @@ Context *Context::create(const char *title, const Style &style) {
 }
 
 void Context::destroy(Context *ctx) {
+    if (ctx == nullptr) {
+        return;
+    }
+    delete ctx->mWidgetPool;
+    delete ctx->mWidgetTree;
+    delete ctx->mCommandQueue;
+    delete ctx->mEventBus;
+    delete ctx->mTimers;
+    if (ctx->mRecorder != nullptr) {
+        IODevice::setRecorder(nullptr);
+        delete ctx->mRecorder;
+    }
     delete ctx;
 }
 
@@ -99,6 +161,7 @@ bool TinyUi::destroyContext() {
 
     Context::destroy(gCtx);
     gCtx = nullptr;
+    Logger::flush();
 
     return true;
 }
@@ -108,14 +171,28 @@ Context &TinyUi::getContext() {
     return *gCtx;
 }
 
-ret_code TinyUi::initScreen(int32_t x, int32_t y, int32_t w, int32_t h) {
+ret_code TinyUi::initScreen(int32_t x, int32_t y, int32_t w, int32_t h, RenderBackendI *backend) {
     auto &ctx = getContext();
-    if (Renderer::initRenderer(ctx) == ErrorCode) {
-        printf("Error: Cannot init renderer\n");
+    if (backend == nullptr) {
+        backend = new SDL2RenderBackend;
+    }
+
+    return initBackend(ctx, backend, x, y, w, h);
+}
+
+ret_code TinyUi::initHeadlessScreen(int32_t w, int32_t h) {
+    auto &ctx = getContext();
+
+    return initBackend(ctx, new SDL2RenderBackend(true), 0, 0, w, h);
+}
+
+ret_code TinyUi::getFramebuffer(Framebuffer &framebuffer) {
+    auto &ctx = getContext();
+    if (!ctx.mCreated) {
         return ErrorCode;
     }
 
-    return Renderer::initScreen(ctx, x, y, w, h);
+    return ctx.mBackend->getFramebuffer(ctx, framebuffer);
 }
 
 ret_code TinyUi::getSurfaceInfo(int32_t &w, int32_t &h) {
@@ -125,7 +202,7 @@ ret_code TinyUi::getSurfaceInfo(int32_t &w, int32_t &h) {
         return ErrorCode;
     }
 
-    return Renderer::getSurfaceInfo(ctx, w, h);
+    return ctx.mBackend->getSurfaceInfo(ctx, w, h);
 }
 
 ret_code TinyUi::getSurfaceCenter(int32_t &x, int32_t &y) {
@@ -143,42 +220,145 @@ ret_code TinyUi::getSurfaceCenter(int32_t &x, int32_t &y) {
 }
 
 bool TinyUi::run() {
-    const auto &ctx = getContext();
+    TINYUI_PROFILE_FRAME();
+    TINYUI_PROFILE_SCOPE("run");
+    auto &ctx = getContext();
+    processCommands(ctx);
+    ctx.mTimers->advance(getTicks());
     if (!ctx.mUpdateCallbackList.empty()) {
+        TINYUI_PROFILE_SCOPE("update_callbacks");
         for (auto it = ctx.mUpdateCallbackList.begin(); it != ctx.mUpdateCallbackList.end(); ++it) {
             WidgetHandle handle{1};
             (*it)->mfuncCallback[Events::UpdateEvent](handle, (*it)->mInstance);
         }
     }
-    return Renderer::update(ctx);
+    if (ctx.mBackend == nullptr) {
+        return false;
+    }
+
+    bool running = false;
+    {
+        TINYUI_PROFILE_SCOPE("events");
+        running = ctx.mBackend->update(ctx);
+        if (ctx.mRecorder != nullptr) {
+            ctx.mRecorder->endFrame(IODevice::getTicks());
+        }
+        if (!running) {
+            Event event;
+            event.mId = Events::QuitEvent;
+            ctx.mEventBus->post(event);
+        }
+        ctx.mEventBus->dispatch();
+    }
+
+    return running;
+}
+
+void TinyUi::setIdleMode(bool enabled, uint32_t updateIntervalMs) {
+    auto &ctx = getContext();
+    ctx.mWaitForEvents = enabled;
+    ctx.mUpdateInterval = updateIntervalMs;
+    ctx.mCommandQueue->setWakeUpEnabled(enabled);
+}
+
+void TinyUi::postCommand(WidgetCommand &&command) {
+    auto &ctx = getContext();
+    ctx.mCommandQueue->push(std::move(command));
+    if (ctx.mCommandQueue->markWakeUp()) {
+        wakeUp();
+    }
+}
+
+SubscriptionToken TinyUi::subscribe(int32_t eventId, EventListener listener, void *instance) {
+    auto &ctx = getContext();
+    return ctx.mEventBus->subscribe(eventId, listener, instance);
+}
+
+ret_code TinyUi::unsubscribe(SubscriptionToken token) {
+    auto &ctx = getContext();
+    return ctx.mEventBus->unsubscribe(token) ? ResultOk : ErrorCode;
+}
+
+TimerId TinyUi::addTimer(uint32_t delayMs, uint32_t periodMs, TimerCallback callback, void *instance) {
+    auto &ctx = getContext();
+    return ctx.mTimers->add(getTicks(), delayMs, periodMs, callback, instance);
+}
+
+ret_code TinyUi::cancelTimer(TimerId id) {
+    auto &ctx = getContext();
+    return ctx.mTimers->cancel(id) ? ResultOk : ErrorCode;
+}
+
+void TinyUi::wakeUp() {
+    auto &ctx = getContext();
+    if (ctx.mBackend != nullptr) {
+        ctx.mBackend->wakeUp();
+    }
 }
 
 ret_code TinyUi::beginRender(Color4 bg) {
     auto &ctx = getContext();
-    return Renderer::beginRender(ctx, bg);
+    if (ctx.mBackend == nullptr) {
+        return ErrorCode;
+    }
+
+    ctx.mFrameStats = FrameStats{};
+
+    return ctx.mBackend->beginRender(ctx, bg);
 }
 
 ret_code TinyUi::endRender() {
     auto &ctx = getContext();
-    return Renderer::endRender(ctx);
+    if (ctx.mBackend == nullptr) {
+        return ErrorCode;
+    }
+
+    TINYUI_PROFILE_SCOPE("present");
+    const ret_code result = ctx.mBackend->endRender(ctx);
+    ctx.mLastFrameStats = ctx.mFrameStats;
+    ++ctx.mNumFrames;
+
+    const DirtyRegion damage = ctx.mDirtyRegion;
+    ctx.mDirtyRegion.clear();
+    Widgets::updateStatsOverlay(damage);
+
+    return result;
 }
 
 void TinyUi::render() {
-    const auto &ctx = getContext();
+    TINYUI_PROFILE_SCOPE("render");
+    auto &ctx = getContext();
+    {
+        TINYUI_PROFILE_SCOPE("layout");
+        Layout::update(ctx);
+    }
+
+    if (!ctx.mDirtyRegion.isDirty()) {
+        return;
+    }
+
     beginRender(ctx.mStyle.mClearColor);
     Widgets::renderWidgets();
     endRender();
 }
 
+void TinyUi::invalidate() {
+    auto &ctx = getContext();
+    ctx.mDirtyRegion.invalidateAll();
+}
+
 ret_code TinyUi::release() {
     auto &ctx = getContext();
     if (!ctx.mCreated) {
         return ErrorCode;
     }
-    Renderer::releaseRenderer(ctx);
-    Renderer::releaseScreen(ctx);
+    // Release the widgets first, the cached image textures depend on the renderer
     Widgets::clear();
-    ctx.mFocus = nullptr;
+    ctx.mBackend->releaseRenderer(ctx);
+    ctx.mBackend->releaseScreen(ctx);
+    delete ctx.mBackend;
+    ctx.mBackend = nullptr;
+    ctx.mFocus = WidgetHandle{};
     ctx.mRoot = nullptr;
 
     ctx.mCreated = false;
@@ -211,8 +391,104 @@ void TinyUi::setDefaultFont(const char *defaultFont) {
     ctx.mStyle.mFont.mName = defaultFont;
 }
 
+void TinyUi::setKeepImageData(bool keep) {
+    auto &ctx = getContext();
+    ctx.mKeepImageData = keep;
+}
+
+ret_code TinyUi::setTextCacheBudget(size_t budget) {
+    auto &ctx = getContext();
+    if (ctx.mBackend == nullptr) {
+        return ErrorCode;
+    }
+
+    return ctx.mBackend->setTextCacheBudget(ctx, budget);
+}
+
+ret_code TinyUi::getTextCacheStats(TextCacheStats &stats) {
+    auto &ctx = getContext();
+    if (ctx.mBackend == nullptr) {
+        return ErrorCode;
+    }
+
+    return ctx.mBackend->getTextCacheStats(ctx, stats);
+}
+
+ret_code TinyUi::getFrameTimeStats(FrameTimeStats &stats) {
+    return Profiler::getFrameTimeStats(stats);
+}
+
+ret_code TinyUi::exportProfile(const char *filename) {
+    return Profiler::exportChromeTrace(filename);
+}
+
+ret_code TinyUi::beginRecording(const char *filename) {
+    auto &ctx = getContext();
+    if (ctx.mBackend == nullptr || ctx.mReplaying) {
+        return ErrorCode;
+    }
+
+    if (ctx.mRecorder == nullptr) {
+        ctx.mRecorder = new EventRecorder;
+    }
+    if (ctx.mRecorder->begin(filename, IODevice::getTicks()) != ResultOk) {
+        return ErrorCode;
+    }
+    IODevice::setRecorder(ctx.mRecorder);
+
+    return ResultOk;
+}
+
+ret_code TinyUi::endRecording() {
+    auto &ctx = getContext();
+    if (ctx.mRecorder == nullptr) {
+        return ErrorCode;
+    }
+    IODevice::setRecorder(nullptr);
+
+    return ctx.mRecorder->end();
+}
+
+ret_code TinyUi::replay(const char *filename, ReplaySpeed speed, ReplayStats &stats) {
+    auto &ctx = getContext();
+    stats = ReplayStats{};
+    if (ctx.mBackend == nullptr || ctx.mReplaying) {
+        return ErrorCode;
+    }
+
+    // The replayed events would be recorded again
+    if (ctx.mRecorder != nullptr && ctx.mRecorder->isRecording()) {
+        ctx.mLogger(LogSeverity::Error, "Cannot replay while recording.");
+        return ErrorCode;
+    }
+
+    EventReplayer replayer;
+    if (replayer.load(filename) != ResultOk) {
+        TINYUI_LOG(ctx, LogSeverity::Error, "Cannot load the input trace %s.", filename != nullptr ? filename : "");
+        return ErrorCode;
+    }
+
+    return replayer.run(ctx, speed, stats);
+}
+
+void TinyUi::setLogSeverity(LogSeverity severity) {
+    Logger::setMinSeverity(severity);
+}
+
+ret_code TinyUi::getFrameStats(FrameStats &stats) {
+    auto &ctx = getContext();
+    stats = ctx.mLastFrameStats;
+
+    return ctx.mNumFrames > 0 ? ResultOk : ErrorCode;
+}
+
 uint32_t TinyUi::getTicks() {
-    return IODevice::getTicks();
+    const auto &ctx = getContext();
+    if (ctx.mReplaying) {
+        return ctx.mReplayTicks;
+    }
+
+    return IODevice::getTicks() + ctx.mTickOffset;
 }
 
 } // namespace tinyui
@@ -29,6 +29,7 @@ SOFTWARE.
 #include <cassert>
 #include <vector>
 #include <list>
+#include <new>
 #include <string>
 #include <unordered_map>
 
@@ -85,6 +86,14 @@ namespace tinyui {
 struct SurfaceImpl;
 struct FontImpl;
 struct Widget;
+struct RenderBackendI;
+struct WidgetPool;
+struct WidgetTree;
+struct CommandQueue;
+struct WidgetCommand;
+struct EventBus;
+struct TimerWheel;
+struct EventRecorder;
 
 struct SDLContext;
 
@@ -97,10 +106,25 @@ using Id = uint64_t;
 using ret_code = int32_t;
 
 /// @brief The widget handle struct.
+///
+/// The id stores the slot index of the widget in the lower 32 bits and the generation of the
+/// slot in the upper 32 bits.
 struct WidgetHandle {
-    static constexpr Id RootItem = 0;       ///< The root item id.
-    static constexpr Id InvalidId = 999999; ///< The invalid id of the widget handle.
-    Id mId{InvalidId};                      ///< The unique id of the widget.    
+    static constexpr Id RootItem = 0;               ///< The root item id.
+    static constexpr Id InvalidId = ~static_cast<Id>(0); ///< The invalid id of the widget handle.
+    Id mId{InvalidId};                              ///< The unique id of the widget.    
+
+    /// @brief Will return the slot index of the handle.
+    /// @return The slot index.
+    uint32_t getIndex() const {
+        return static_cast<uint32_t>(mId & 0xFFFFFFFFu);
+    }
+
+    /// @brief Will return the generation of the handle.
+    /// @return The generation.
+    uint32_t getGeneration() const {
+        return static_cast<uint32_t>(mId >> 32);
+    }
     
     /// @brief Check if the widget handle is valid.
     /// @return true if the widget handle is valid, false if not.
@@ -233,6 +257,12 @@ struct Rect {
     /// @brief The class destructor.
     ~Rect() = default;
 
+    /// @brief Check if the rectangle covers no area, this is also true for a default constructed one.
+    /// @return true if the rectangle is empty, false if not.
+    bool isEmpty() const {
+        return width <= 0 || height <= 0;
+    }
+
     /// @brief Check if a point is inside the rectangle.
     /// @param pt   The point to check.
     /// @return true if the point is inside the rectangle, false if not.
@@ -266,28 +296,100 @@ struct Rect {
     }
 
     /// @brief Merge the rectangle with another rectangle.
+    ///
+    /// An empty rectangle will be replaced by the other one, merging an empty one changes nothing.
     /// @param r The rectangle to merge with.
     void mergeWithRect(const Rect &r) {
-        if (top.x > r.top.x || top.x == -1) {
+        if (r.isEmpty()) {
+            return;
+        }
+
+        if (isEmpty()) {
+            set(r.top.x, r.top.y, r.width, r.height);
+            return;
+        }
+
+        if (top.x > r.top.x) {
             top.x = r.top.x;
         }
 
-        if (top.y > r.top.y || top.y == -1) {
+        if (top.y > r.top.y) {
             top.y = r.top.y;
         }
 
-        if (const int x2_ = top.x + r.width; bottom.x < x2_) {
-            bottom.x = x2_;
-            width = r.width;
+        if (bottom.x < r.bottom.x) {
+            bottom.x = r.bottom.x;
         }
 
-        if (const int y2_ = bottom.y + r.height; bottom.y < y2_) {
-            bottom.y = y2_;
-            height = r.height;
+        if (bottom.y < r.bottom.y) {
+            bottom.y = r.bottom.y;
         }
+        width = bottom.x - top.x;
+        height = bottom.y - top.y;
     }
 };
 
+/// @brief The dirty region, collects all areas which need to be redrawn in the next frame.
+struct DirtyRegion {
+    Rect mBounds{};             ///< The union of all damaged areas.
+    bool mDirty{false};         ///< true if at least one area was damaged.
+    bool mFullRedraw{true};     ///< true if the whole surface needs to be redrawn.
+
+    /// @brief Will add a damaged area.
+    /// @param r The damaged area.
+    void add(const Rect &r) {
+        if (r.width <= 0 || r.height <= 0) {
+            return;
+        }
+
+        if (!mDirty) {
+            mBounds = r;
+            mDirty = true;
+            return;
+        }
+
+        const int32_t x0 = r.top.x < mBounds.top.x ? r.top.x : mBounds.top.x;
+        const int32_t y0 = r.top.y < mBounds.top.y ? r.top.y : mBounds.top.y;
+        const int32_t x1 = r.bottom.x > mBounds.bottom.x ? r.bottom.x : mBounds.bottom.x;
+        const int32_t y1 = r.bottom.y > mBounds.bottom.y ? r.bottom.y : mBounds.bottom.y;
+        mBounds.set(x0, y0, x1 - x0, y1 - y0);
+    }
+
+    /// @brief Will mark the whole surface as damaged.
+    void invalidateAll() {
+        mFullRedraw = true;
+    }
+
+    /// @brief Will reset the region after a frame was rendered.
+    void clear() {
+        mBounds = Rect();
+        mDirty = false;
+        mFullRedraw = false;
+    }
+
+    /// @brief Will return true if anything needs to be redrawn.
+    /// @return true if a redraw is required.
+    bool isDirty() const {
+        return mFullRedraw || mDirty;
+    }
+
+    /// @brief Will return true if only a part of the surface needs to be redrawn.
+    /// @return true for a partial redraw.
+    bool isPartial() const {
+        return !mFullRedraw && mDirty;
+    }
+};
+
+/// @brief The framebuffer of a headless screen.
+///
+/// The pixels are stored as 8-bit RGBA, row by row.
+struct Framebuffer {
+    const uint8_t *mPixels{nullptr};    ///< The pixel data.
+    int32_t        mWidth{0};           ///< The width in pixels.
+    int32_t        mHeight{0};          ///< The height in pixels.
+    int32_t        mPitch{0};           ///< The number of bytes per row.
+};
+
 /// @brief The alignment enum.
 enum class Alignment : int32_t {
     Invalid = -1,               ///< The invalid alignment.
@@ -307,6 +409,51 @@ struct Font {
 /// @brief The font cache.
 using FontCache = std::unordered_map<const char*, Font*>;
 
+/// @brief The statistics of the rendered text cache.
+struct TextCacheStats {
+    uint64_t mHits{0};          ///< The number of cache hits.
+    uint64_t mMisses{0};        ///< The number of cache misses.
+    uint64_t mEvictions{0};     ///< The number of evicted entries.
+    size_t   mNumEntries{0};    ///< The number of cached entries.
+    size_t   mBytes{0};         ///< The used memory in bytes.
+    size_t   mBudget{0};        ///< The memory budget in bytes.
+};
+
+/// @brief The speed of a replayed input recording.
+enum class ReplaySpeed {
+    Invalid = -1,   ///< Not initialized
+    Recorded = 0,   ///< The events are sent with the recorded timing.
+    Maximum,        ///< The frames are replayed back to back.
+    Count           ///< The number of replay speeds
+};
+
+/// @brief The render statistics of one frame.
+struct FrameStats {
+    size_t mNumDrawCalls{0};        ///< The number of draw calls submitted to the driver.
+    size_t mNumRects{0};            ///< The number of drawn rectangles.
+    size_t mNumTexts{0};            ///< The number of drawn texts.
+    size_t mNumImages{0};           ///< The number of drawn images.
+    size_t mNumTexturesCreated{0};  ///< The number of created textures.
+    size_t mNumTextureUploads{0};   ///< The number of textures filled with pixel data.
+    size_t mNumGlyphHits{0};        ///< The number of glyphs drawn from the glyph atlas.
+    size_t mNumTextCacheHits{0};    ///< The number of texts drawn from the text cache.
+    size_t mNumTextCacheMisses{0};  ///< The number of texts which needed to be rendered.
+    size_t mNumWidgetsVisited{0};   ///< The number of rendered widgets.
+    size_t mNumWidgetsCulled{0};    ///< The number of widgets skipped as they were not visible.
+
+    bool operator==(const FrameStats &rhs) const = default;
+};
+
+/// @brief The frame time statistics of the profiler, all times in ns.
+struct FrameTimeStats {
+    size_t   mNumFrames{0};     ///< The number of measured frames.
+    uint64_t mMin{0};           ///< The shortest frame.
+    uint64_t mP50{0};           ///< The median frame time.
+    uint64_t mP95{0};           ///< The 95th percentile.
+    uint64_t mP99{0};           ///< The 99th percentile.
+    uint64_t mMax{0};           ///< The longest frame.
+};
+
 /// @brief The style struct.
 ///
 /// The style struct is used to describe the style of the tiny ui.
@@ -348,11 +495,12 @@ struct Events {
     static constexpr int32_t MouseButtonDownEvent = 1;      ///< The mouse button down event.
     static constexpr int32_t MouseButtonUpEvent = 2;        ///< The mouse button up event.
     static constexpr int32_t MouseMoveEvent = 3;            ///< The mouse move event.
-    static constexpr int32_t MouseHoverEvent = 4;           ///< The mouse hover event.
+    static constexpr int32_t MouseHoverEvent = 4;           ///< The mouse entered the widget.
     static constexpr int32_t KeyDownEvent = 5;              ///< The key down event.
     static constexpr int32_t KeyUpEvent = 6;                ///< The key up event.
     static constexpr int32_t UpdateEvent = 7;               ///< The update event.
-    static constexpr int32_t NumEvents = UpdateEvent + 1;   ///< The number of events.
+    static constexpr int32_t MouseLeaveEvent = 8;           ///< The mouse left the widget.
+    static constexpr int32_t NumEvents = MouseLeaveEvent + 1; ///< The number of events.
 };
 
 /// @brief The payload identifier for the events.
@@ -430,11 +578,27 @@ struct CallbackI {
     }
 };
 
-/// @brief The event callback array.
-using EventCallbackArray = std::vector<CallbackI*>;
+/// @brief An event as seen by the listeners of the event bus.
+struct Event {
+    int32_t      mId{Events::InvalidEvent};         ///< The event id.
+    WidgetHandle mTarget{};                         ///< The widget receiving the event, invalid if none.
+    int32_t      mX{0};                             ///< The x-coordinate of the mouse.
+    int32_t      mY{0};                             ///< The y-coordinate of the mouse.
+    MouseState   mMouseState{MouseState::Invalid};  ///< The mouse state.
+    EventPayload mPayload{};                        ///< The event payload, for instance the key.
+};
+
+/// @brief The event listener function type.
+typedef void (*EventListener)(const Event &event, void *instance);
+
+/// @brief The token to identify an event bus subscription.
+using SubscriptionToken = uint64_t;
+
+/// @brief The id of a timer.
+using TimerId = uint64_t;
 
-/// @brief The event dispatch map.
-using EventDispatchMap = std::unordered_map<int32_t, EventCallbackArray>;
+/// @brief The timer callback function type.
+typedef void (*TimerCallback)(TimerId id, void *instance);
 
 /// @brief Function pointer declaration for callbacks.
 typedef void (*tui_log_func) (LogSeverity severity, const char *message);
@@ -442,11 +606,224 @@ typedef void (*tui_log_func) (LogSeverity severity, const char *message);
 /// @brief The update callback list.
 using UpdateCallbackList = std::list<CallbackI*>;
 
+/// @brief A pool allocator for objects of the same type.
+///
+/// The objects are allocated from blocks of contiguous memory. Released objects are kept in a
+/// free list for reuse. All objects can be destroyed at once by reset, the blocks are kept for
+/// the next allocations.
+/// @tparam T         The object type.
+/// @tparam BlockSize The number of objects per block.
+template<class T, size_t BlockSize = 256>
+struct ObjectPool {
+    /// @brief The default class constructor.
+    ObjectPool() = default;
+
+    /// @brief The class destructor, will destroy all objects and free the blocks.
+    ~ObjectPool() {
+        reset();
+        for (Block *block : mBlocks) {
+            delete block;
+        }
+    }
+
+    // Disable copy and assignment
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    /// @brief Will create a new object.
+    /// @return The new object.
+    T *create() {
+        Slot *slot = mFreeList;
+        if (slot != nullptr) {
+            mFreeList = slot->mNextFree;
+        } else {
+            if (mNumUsed == mBlocks.size() * BlockSize) {
+                mBlocks.push_back(new Block);
+            }
+            slot = &mBlocks[mNumUsed / BlockSize]->mSlots[mNumUsed % BlockSize];
+            ++mNumUsed;
+        }
+        slot->mAlive = true;
+        ++mNumAlive;
+
+        return new (slot->mStorage) T;
+    }
+
+    /// @brief Will destroy an object and put its memory back into the pool.
+    /// @param[in] object The object to release.
+    void release(T *object) {
+        if (object == nullptr) {
+            return;
+        }
+
+        object->~T();
+        Slot *slot = reinterpret_cast<Slot*>(object);
+        slot->mAlive = false;
+        slot->mNextFree = mFreeList;
+        mFreeList = slot;
+        --mNumAlive;
+    }
+
+    /// @brief Will call a function for all living objects in memory order.
+    /// @param[in] func The function to call.
+    template<class Func>
+    void forEach(Func func) {
+        for (size_t i = 0; i < mNumUsed; ++i) {
+            Slot &slot = mBlocks[i / BlockSize]->mSlots[i % BlockSize];
+            if (slot.mAlive) {
+                func(*reinterpret_cast<T*>(slot.mStorage));
+            }
+        }
+    }
+
+    /// @brief Will destroy all objects at once.
+    void reset() {
+        for (size_t i = 0; i < mNumUsed && mNumAlive > 0; ++i) {
+            Slot &slot = mBlocks[i / BlockSize]->mSlots[i % BlockSize];
+            if (slot.mAlive) {
+                reinterpret_cast<T*>(slot.mStorage)->~T();
+                slot.mAlive = false;
+                --mNumAlive;
+            }
+        }
+        mNumUsed = 0;
+        mNumAlive = 0;
+        mFreeList = nullptr;
+    }
+
+    /// @brief Will return the number of living objects.
+    /// @return The number of objects.
+    size_t size() const {
+        return mNumAlive;
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char mStorage[sizeof(T)];   ///< The object storage, must be the first member.
+        Slot *mNextFree{nullptr};                       ///< The next free slot.
+        bool  mAlive{false};                            ///< true if the slot stores an object.
+    };
+
+    struct Block {
+        Slot mSlots[BlockSize];                         ///< The slots of the block.
+    };
+
+    std::vector<Block*> mBlocks;                        ///< The allocated blocks.
+    size_t              mNumUsed{0};                    ///< The number of slots handed out from the blocks.
+    size_t              mNumAlive{0};                   ///< The number of living objects.
+    Slot               *mFreeList{nullptr};             ///< The released slots.
+};
+
+/// @brief The slot map to look up widgets by their handle.
+///
+/// Removed slots will be reused with an increased generation, so a handle of a removed widget
+/// will be rejected even if its slot is in use again. Slot 0 is reserved for the root widget.
+struct WidgetSlotMap {
+    /// @brief The default class constructor.
+    WidgetSlotMap() {
+        mSlots.push_back(Slot{});
+    }
+
+    /// @brief Will store a widget in a free slot.
+    /// @param[in] widget The widget to store.
+    /// @return The id of the new handle.
+    Id insert(Widget *widget) {
+        uint32_t index = mFreeHead;
+        if (index != NoSlot) {
+            mFreeHead = mSlots[index].mNextFree;
+        } else {
+            index = static_cast<uint32_t>(mSlots.size());
+            mSlots.push_back(Slot{});
+        }
+
+        Slot &slot = mSlots[index];
+        slot.mWidget = widget;
+        slot.mNextFree = NoSlot;
+        ++mNumWidgets;
+
+        return (static_cast<Id>(slot.mGeneration) << 32) | index;
+    }
+
+    /// @brief Will release the slot of a handle, the handle gets stale.
+    /// @param[in] handle The handle to remove.
+    void remove(WidgetHandle handle) {
+        const uint32_t index = handle.getIndex();
+        if (index == 0 || index >= mSlots.size()) {
+            return;
+        }
+
+        Slot &slot = mSlots[index];
+        if (slot.mWidget == nullptr || slot.mGeneration != handle.getGeneration()) {
+            return;
+        }
+
+        slot.mWidget = nullptr;
+        ++slot.mGeneration;
+        slot.mNextFree = mFreeHead;
+        mFreeHead = index;
+        --mNumWidgets;
+    }
+
+    /// @brief Will return the widget of a handle.
+    /// @param[in] handle The handle.
+    /// @return The widget or nullptr if the handle is invalid or stale.
+    Widget *get(WidgetHandle handle) const {
+        const uint32_t index = handle.getIndex();
+        if (index >= mSlots.size()) {
+            return nullptr;
+        }
+
+        const Slot &slot = mSlots[index];
+        return slot.mGeneration == handle.getGeneration() ? slot.mWidget : nullptr;
+    }
+
+    /// @brief Will release all slots, all handles get stale.
+    void clear() {
+        for (uint32_t i = 1; i < mSlots.size(); ++i) {
+            if (mSlots[i].mWidget != nullptr) {
+                remove(WidgetHandle{ (static_cast<Id>(mSlots[i].mGeneration) << 32) | i });
+            }
+        }
+    }
+
+    /// @brief Will return the number of stored widgets.
+    /// @return The number of widgets.
+    size_t size() const {
+        return mNumWidgets;
+    }
+
+    /// @brief Will return the number of allocated slots.
+    /// @return The number of slots.
+    size_t capacity() const {
+        return mSlots.size();
+    }
+
+private:
+    static constexpr uint32_t NoSlot = ~0u;
+
+    struct Slot {
+        Widget  *mWidget{nullptr};      ///< The widget, nullptr for free slots.
+        uint32_t mGeneration{0};        ///< The generation, increased on every release.
+        uint32_t mNextFree{NoSlot};     ///< The next free slot.
+    };
+
+    std::vector<Slot> mSlots;           ///< The slots.
+    uint32_t          mFreeHead{NoSlot};///< The first free slot.
+    size_t            mNumWidgets{0};   ///< The number of stored widgets.
+};
+
 /// @brief The backend context, used to store the backend specific data.
 struct BackendContext {
     void *mHandle{nullptr}; ///< The backend specific handle.
 };
 
+/// @brief The result of a replayed input recording.
+struct ReplayStats {
+    size_t         mNumEvents{0};   ///< The number of replayed events.
+    uint64_t       mTotalTime{0};   ///< The time of all replayed frames in ns.
+    FrameTimeStats mFrameTimes{};   ///< The times of the replayed frames in ns.
+};
+
 /// @brief The tiny ui context.
 struct Context {
     bool               mCreated{false};             ///< The created state.
@@ -455,17 +832,38 @@ struct Context {
     const char        *mAppTitle{nullptr};          ///< The application title.
     const char        *mWindowsTitle{nullptr};      ///< The window title.
     BackendContext    *mBackendCtx{nullptr};        ///< The backend context.
+    RenderBackendI    *mBackend{nullptr};           ///< The render backend, owned by the context.
     Style              mStyle{};                    ///< The active style.
     Widget            *mRoot{nullptr};              ///< The root widget.
-    Widget            *mFocus{nullptr};             ///< The widget which is in focus.
+    WidgetHandle       mFocus{};                    ///< The widget which is in focus.
+    WidgetHandle       mHovered{};                  ///< The widget under the mouse cursor.
     Font              *mDefaultFont{ nullptr };     ///< The default font.
     Font              *mSelectedFont{ nullptr };    ///< The selected font.
     Widget            *mCurrentParent{ nullptr };   ///< The current parent widget for new widgets.
     tui_log_func       mLogger{};                   ///< The logger function.
-    EventDispatchMap   mEventDispatchMap;           ///< The event dispatch map.
+    EventBus          *mEventBus{nullptr};          ///< The event bus for the global listeners.
+    TimerWheel        *mTimers{nullptr};            ///< The scheduled timers.
+    Rect               mViewport{};                 ///< The visible area, used by the layout containers filling the screen.
+    std::vector<WidgetHandle> mDirtyLayouts{};      ///< The layout roots to update before the next frame.
     FontCache          mFontCache{};                ///< The font cache.
     ImageCache         mImageCache{};               ///< The image cache.
     UpdateCallbackList mUpdateCallbackList{};       ///< The update callback list.
+    WidgetSlotMap      mWidgets{};                  ///< The lookup from the widget handle to the widget.
+    WidgetPool        *mWidgetPool{nullptr};        ///< The allocator for the widgets.
+    WidgetTree        *mWidgetTree{nullptr};        ///< The flattened widget tree.
+    CommandQueue      *mCommandQueue{nullptr};      ///< The commands posted from other threads.
+    bool               mKeepImageData{true};        ///< Keep the CPU-side image pixels after the texture upload.
+    DirtyRegion        mDirtyRegion{};              ///< The areas to redraw in the next frame.
+    bool               mWaitForEvents{false};       ///< Block in run() until an event arrives.
+    uint32_t           mUpdateInterval{16};         ///< The update callback interval in ms while waiting for events.
+    FrameStats         mFrameStats{};               ///< The statistics of the frame in progress, counted by the backend.
+    FrameStats         mLastFrameStats{};           ///< The statistics of the last finished frame.
+    uint64_t           mNumFrames{0};               ///< The number of finished frames.
+    WidgetHandle       mStatsOverlay{};             ///< The statistics overlay widget.
+    EventRecorder     *mRecorder{nullptr};          ///< The recorder for the input events, owned by the context.
+    bool               mReplaying{false};           ///< true while a recorded trace gets replayed.
+    uint32_t           mReplayTicks{0};             ///< The ticks of the replayed frame.
+    uint32_t           mTickOffset{0};              ///< Added to the device ticks, keeps the ticks monotonic after a replay.
 
     /// @brief Will create a new tiny ui context.
     /// @param title The title of the context.
@@ -508,8 +906,23 @@ struct TinyUi {
     /// @param[in] y The y-coordinate of the screen.
     /// @param[in] w The width of the screen.
     /// @param[in] h The height of the screen.
+    /// @param[in] backend The render backend, nullptr for the SDL2 backend. The context takes the ownership.
+    /// @return ResultOk if the initialization was successful, ErrorCode if not.
+    static ret_code initScreen(int32_t x, int32_t y, int32_t w, int32_t h, RenderBackendI *backend = nullptr);
+
+    /// @brief Initialize a headless screen.
+    ///
+    /// The widgets will be rendered by a software renderer into an in-memory framebuffer,
+    /// no window, display or GPU is required.
+    /// @param[in] w The width of the framebuffer.
+    /// @param[in] h The height of the framebuffer.
     /// @return ResultOk if the initialization was successful, ErrorCode if not.
-    static ret_code initScreen(int32_t x, int32_t y, int32_t w, int32_t h);
+    static ret_code initHeadlessScreen(int32_t w, int32_t h);
+
+    /// @brief Will return the framebuffer of a headless screen.
+    /// @param[out] framebuffer The framebuffer, valid until the next rendering.
+    /// @return ResultOk if the framebuffer was retrieved, ErrorCode if not headless.
+    static ret_code getFramebuffer(Framebuffer &framebuffer);
 
     /// @brief Get the surface information.
     /// @param[out] w The width of the surface.
@@ -527,6 +940,60 @@ struct TinyUi {
     /// @return true if the tiny ui is running, false if not.
     static bool run();
 
+    /// @brief Will enable the event-driven idle mode.
+    ///
+    /// In the idle mode run() blocks until input arrives, an update callback is due or
+    /// wakeUp() was called. Combined with the dirty tracking of render() an idle ui will
+    /// not consume any CPU time.
+    /// @note While any update callback is registered, for instance by a progress bar, run()
+    /// wakes up at least every updateIntervalMs, so the ui never idles. Use addTimer for
+    /// periodic work instead, the wait then only ends when the next timer is due.
+    /// @param[in] enabled          true to wait for events, false to poll.
+    /// @param[in] updateIntervalMs The interval in ms to call the update callbacks while waiting.
+    static void setIdleMode(bool enabled, uint32_t updateIntervalMs = 16);
+
+    /// @brief Will wake up the ui thread waiting in run(), can be called from any thread.
+    static void wakeUp();
+
+    /// @brief Will post a widget command, can be called from any thread.
+    ///
+    /// The commands will be executed in the posted order on the ui thread at the beginning
+    /// of the next run() call. In the idle mode only the first command posted since the last
+    /// run() call wakes up the ui thread.
+    /// @param[in] command The command to post.
+    static void postCommand(WidgetCommand &&command);
+
+    /// @brief Will add a global listener for an event.
+    ///
+    /// The listener sees all input events without walking the widget tree. Events get
+    /// queued while the input is processed and dispatched as one batch at the end of run().
+    /// @param[in] eventId  The event id.
+    /// @param[in] listener The listener function.
+    /// @param[in] instance The instance passed to the listener.
+    /// @return The subscription token, 0 in case of an error.
+    static SubscriptionToken subscribe(int32_t eventId, EventListener listener, void *instance);
+
+    /// @brief Will remove a global listener, can be called from within a listener.
+    /// @param[in] token The subscription token.
+    /// @return ResultOk if the listener was removed, ErrorCode if the token is unknown.
+    static ret_code unsubscribe(SubscriptionToken token);
+
+    /// @brief Will add a timer, the callback will be called from run() when the timer is due.
+    ///
+    /// Only the due timers are visited per frame, and in idle mode run() will sleep until
+    /// the next timer is due.
+    /// @param[in] delayMs  The delay until the first call in ms.
+    /// @param[in] periodMs The period in ms for repeating timers, 0 for one-shot timers.
+    /// @param[in] callback The callback.
+    /// @param[in] instance The instance passed to the callback.
+    /// @return The timer id, 0 in case of an error.
+    static TimerId addTimer(uint32_t delayMs, uint32_t periodMs, TimerCallback callback, void *instance);
+
+    /// @brief Will cancel a timer, can be called from within a timer callback.
+    /// @param[in] id The timer id.
+    /// @return ResultOk if the timer was canceled, ErrorCode if the timer is unknown or expired.
+    static ret_code cancelTimer(TimerId id);
+
     /// @brief Begins the rendering.
     /// @param[in] bg The background color for clearing.
     /// @return ResultOk if the rendering was started, ErrorCode if not.
@@ -536,8 +1003,14 @@ struct TinyUi {
     static ret_code endRender();
 
     /// @brief Render the ui.
+    ///
+    /// Only the damaged areas will be redrawn, if nothing has changed since the last frame
+    /// the rendering and presenting will be skipped.
     static void render();
 
+    /// @brief Will mark the whole surface to be redrawn in the next frame.
+    static void invalidate();
+
     /// @brief Release the tiny ui context.
     /// @return ResultOk if the context was released, ErrorCode if not.
     static ret_code release();
@@ -554,7 +1027,62 @@ struct TinyUi {
     /// @param[in] defaultFont The default font to set.
     static void setDefaultFont(const char *defaultFont);
     
-    /// @brief Will return the current counted ticks in ms.
+    /// @brief Will control if the CPU-side image pixels are kept after the upload to the GPU.
+    /// @param[in] keep true to keep the pixel data, false to release it after the upload.
+    static void setKeepImageData(bool keep);
+
+    /// @brief Will set the memory budget of the rendered text cache.
+    /// @param[in] budget The budget in bytes.
+    /// @return ResultOk if the budget was set, ErrorCode if not.
+    static ret_code setTextCacheBudget(size_t budget);
+
+    /// @brief Will return the statistics of the rendered text cache.
+    /// @param[out] stats The statistics.
+    /// @return ResultOk if the statistics were retrieved, ErrorCode if not.
+    static ret_code getTextCacheStats(TextCacheStats &stats);
+
+    /// @brief Will return the frame times measured by the profiler.
+    /// @note Frames are only measured when TINYUI_PROFILE_ENABLED is defined.
+    /// @param[out] stats The frame time statistics.
+    /// @return ResultOk if frames were measured, ErrorCode if not.
+    static ret_code getFrameTimeStats(FrameTimeStats &stats);
+
+    /// @brief Will start to record the input events into a trace file.
+    /// @param[in] filename The name of the trace file, written when the recording ends.
+    /// @return ResultOk if the recording was started, ErrorCode if no screen exists or already recording.
+    static ret_code beginRecording(const char *filename);
+
+    /// @brief Will stop the recording and write the trace file.
+    /// @return ResultOk if the trace file was written, ErrorCode if not.
+    static ret_code endRecording();
+
+    /// @brief Will replay a recorded trace and measure the frame times.
+    ///
+    /// Every recorded frame runs one TinyUi::run and TinyUi::render call. While replaying,
+    /// TinyUi::getTicks returns the recorded time of the frame, so the timers and the update
+    /// callbacks see the same clock in every replay. Frames without input events are not
+    /// recorded, their timers fire in the next replayed frame.
+    /// @param[in]  filename    The name of the trace file.
+    /// @param[in]  speed       The replay speed.
+    /// @param[out] stats       The replay statistics.
+    /// @return ResultOk if the trace was replayed, ErrorCode if not.
+    static ret_code replay(const char *filename, ReplaySpeed speed, ReplayStats &stats);
+
+    /// @brief Will set the lowest severity written by the default logger.
+    /// @param[in] severity The lowest severity, the messages below will be dropped.
+    static void setLogSeverity(LogSeverity severity);
+
+    /// @brief Will return the render statistics of the last finished frame.
+    /// @param[out] stats The frame statistics.
+    /// @return ResultOk if a frame was rendered, ErrorCode if not.
+    static ret_code getFrameStats(FrameStats &stats);
+
+    /// @brief Will write the recorded profiler scopes as Chrome trace-event JSON.
+    /// @param[in] filename The name of the trace file, open it in chrome://tracing or Perfetto.
+    /// @return ResultOk if the file was written, ErrorCode if not.
+    static ret_code exportProfile(const char *filename);
+
+    /// @brief Will return the current counted ticks in ms, the recorded ones while replaying.
     /// @return The ticks in ms.
     static uint32_t getTicks();
 };
@@ -25,3 +25,9 @@ SOFTWARE.
 
 // Enable this to get verbose logs.
 //#define TINYUI_TRACE_ENABLED
+
+// Enable this to record the frame profiler scopes.
+//#define TINYUI_PROFILE_ENABLED
+
+// Set this to the lowest log severity to compile in, 0 keeps all messages.
+//#define TINYUI_LOG_MIN_SEVERITY 0
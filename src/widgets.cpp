@@ -23,7 +23,10 @@ SOFTWARE.
 */
 
 #include "widgets.h"
-#include "backends/sdl2_renderer.h"
+#include "backends/render_backend.h"
+#include "event_bus.h"
+#include "profiler.h"
+#include "layout.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -32,16 +35,106 @@ SOFTWARE.
 #include <cassert>
 #include <cstring>
 #include <algorithm>
+#include <limits>
 
 namespace tinyui {
 
-static constexpr Id RootHandle = 1;
-
 namespace {
 
-    Id createHandle() {
-        static Id id{ RootHandle };
-        return ++id;
+    /// The key code of the backspace key, the same as the ASCII code.
+    constexpr char BackspaceKey = '\b';
+
+    WidgetPool &getWidgetPool(Context &ctx) {
+        if (ctx.mWidgetPool == nullptr) {
+            ctx.mWidgetPool = new WidgetPool;
+        }
+
+        return *ctx.mWidgetPool;
+    }
+
+    void releaseWidget(Context &ctx, Widget *widget) {
+        WidgetPool &pool = getWidgetPool(ctx);
+        pool.mCheckBoxes.release(widget->mCheckBoxContext);
+        pool.mLayouts.release(widget->mLayout);
+        pool.mWidgets.release(widget);
+    }
+
+    WidgetTree &getValidWidgetTree(Context &ctx) {
+        if (ctx.mWidgetTree == nullptr) {
+            ctx.mWidgetTree = new WidgetTree;
+        }
+
+        WidgetTree &tree = *ctx.mWidgetTree;
+        if (!tree.mValid) {
+            tree.rebuild(ctx.mRoot);
+        }
+        tree.settle(ctx.mNumFrames);
+
+        return tree;
+    }
+
+    void invalidateTree(Context &ctx) {
+        if (ctx.mWidgetTree != nullptr) {
+            ctx.mWidgetTree->invalidate();
+        }
+    }
+
+    void syncTree(Context &ctx, const Widget *widget) {
+        if (ctx.mWidgetTree != nullptr) {
+            ctx.mWidgetTree->sync(widget);
+        }
+    }
+
+    void fireEvent(const Widget *widget, int32_t eventId) {
+        if (widget == nullptr || widget->mCallback == nullptr) {
+            return;
+        }
+
+        CallbackI *callback = widget->mCallback;
+        if (callback->mfuncCallback[eventId] != nullptr) {
+            callback->mfuncCallback[eventId](widget->mHandle, callback->mInstance);
+        }
+    }
+
+    void postEvent(Context &ctx, int32_t eventId, WidgetHandle target, int x, int y, MouseState state) {
+        if (ctx.mEventBus == nullptr) {
+            return;
+        }
+
+        Event event;
+        event.mId = eventId;
+        event.mTarget = target;
+        event.mX = x;
+        event.mY = y;
+        event.mMouseState = state;
+        ctx.mEventBus->post(event);
+    }
+
+    void unregisterWidget(Context &ctx, const Widget *widget) {
+        ctx.mWidgets.remove(widget->mHandle);
+    }
+
+    void releaseCallback(Context &ctx, Widget *widget) {
+        if (widget->mCallback == nullptr) {
+            return;
+        }
+
+        // The progress bars are updated through their callback, which must not be called after the release
+        if (widget->mType == WidgetType::ProgressBar) {
+            ctx.mUpdateCallbackList.remove(widget->mCallback);
+        }
+        widget->mCallback->decRef();
+        widget->mCallback = nullptr;
+    }
+
+    void releaseChildren(Context &ctx, Widget *widget) {
+        for (Widget *child : widget->mChildren) {
+            releaseChildren(ctx, child);
+            unregisterWidget(ctx, child);
+            releaseCallback(ctx, child);
+            releaseWidget(ctx, child);
+        }
+        widget->mChildren.clear();
     }
 
     Image *findImage(Context &ctx, const char *filename) {
@@ -58,7 +151,7 @@ namespace {
     }
 
     Image *loadIntoImageCache(Context &ctx, const char *filename) {
-        if (filename == nullptr) {
+        if (filename == nullptr || ctx.mBackend == nullptr) {
             return nullptr;
         }
 
@@ -82,7 +175,7 @@ namespace {
 
         int32_t pitch = w * bytesPerPixel;
         pitch = (pitch + 3) & ~3;
-        image->mSurfaceImpl = Renderer::createSurfaceImpl(data, w, h, bytesPerPixel, pitch);
+        image->mSurfaceImpl = ctx.mBackend->createSurfaceImpl(data, w, h, bytesPerPixel, pitch);
         image->mX = w;
         image->mY = h;
         image->mComp = bytesPerPixel;
@@ -94,7 +187,9 @@ namespace {
     void releaseImageCache(Context &ctx) {
         for (auto it = ctx.mImageCache.begin(); it != ctx.mImageCache.end(); ++it) {
             if (Image *image = it->second; image != nullptr) {
-                Renderer::releaseSurfaceImpl(image->mSurfaceImpl);
+                if (ctx.mBackend != nullptr) {
+                    ctx.mBackend->releaseSurfaceImpl(image->mSurfaceImpl);
+                }
                 delete image;
             }
         }
@@ -106,13 +201,103 @@ namespace {
             return ctx.mRoot;
         }
 
-        ctx.mRoot = new Widget;
+        ctx.mRoot = getWidgetPool(ctx).mWidgets.create();
         ctx.mRoot->mType = WidgetType::RootContainer;
         ctx.mRoot->mHandle = WidgetHandle::getRootHandle();
 
         return ctx.mRoot;
     }
 
+    struct ClipEntry {
+        Rect     mRect;     ///< The clip rectangle.
+        uint32_t mEnd;      ///< The index behind the clipped subtree.
+    };
+
+    struct OriginEntry {
+        Point2i  mOrigin;   ///< The screen origin of the children.
+        uint32_t mEnd;      ///< The index behind the subtree.
+    };
+
+    bool isIntersecting(const Rect &a, const Rect &b) {
+        return a.width > 0 && a.height > 0 && b.width > 0 && b.height > 0 &&
+            a.top.x < b.top.x + b.width && b.top.x < a.top.x + a.width &&
+            a.top.y < b.top.y + b.height && b.top.y < a.top.y + a.height;
+    }
+
+    Rect getIntersection(const Rect &a, const Rect &b) {
+        const int32_t x0 = std::max(a.top.x, b.top.x);
+        const int32_t y0 = std::max(a.top.y, b.top.y);
+        const int32_t x1 = std::min(a.top.x + a.width, b.top.x + b.width);
+        const int32_t y1 = std::min(a.top.y + a.height, b.top.y + b.height);
+        return Rect(x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0));
+    }
+
+    Rect offsetRect(const Rect &r, const Point2i &origin) {
+        return Rect(origin.x + r.top.x, origin.y + r.top.y, r.width, r.height);
+    }
+
+    Rect mergeRects(const Rect &a, const Rect &b) {
+        if (a.width <= 0 || a.height <= 0) {
+            return b;
+        }
+
+        const int32_t x0 = std::min(a.top.x, b.top.x);
+        const int32_t y0 = std::min(a.top.y, b.top.y);
+        const int32_t x1 = std::max(a.top.x + a.width, b.top.x + b.width);
+        const int32_t y1 = std::max(a.top.y + a.height, b.top.y + b.height);
+        return Rect(x0, y0, x1 - x0, y1 - y0);
+    }
+
+    Point2i getParentOrigin(const Widget *widget) {
+        return widget->mParent != nullptr ? widget->mParent->getOrigin() : Point2i(0, 0);
+    }
+
+    void markDirty(Context &ctx, const Widget *widget, const Point2i &origin, bool recursive) {
+        const Rect r = offsetRect(widget->mRect, origin);
+        ctx.mDirtyRegion.add(r);
+        if (recursive) {
+            const Point2i childOrigin = widget->mParent != nullptr ? Point2i(r.top.x, r.top.y) : Point2i(0, 0);
+            for (const Widget *child : widget->mChildren) {
+                markDirty(ctx, child, childOrigin, true);
+            }
+        }
+    }
+
+    void markDirty(Context &ctx, const Widget *widget, bool recursive) {
+        if (widget == nullptr) {
+            return;
+        }
+
+        // The cached subtree bounds avoid the walk over all children
+        const WidgetTree *tree = ctx.mWidgetTree;
+        if (recursive && tree != nullptr && tree->mBoundsValid && tree->contains(widget)) {
+            ctx.mDirtyRegion.add(tree->getScreenBounds(widget->mTreeIndex));
+            return;
+        }
+        markDirty(ctx, widget, getParentOrigin(widget), recursive);
+    }
+
+    void moveWidget(Context &ctx, Widget *widget, int32_t x, int32_t y) {
+        Rect &r = widget->mRect;
+        if (r.top.x == x && r.top.y == y) {
+            return;
+        }
+
+        // The children follow, their rects are relative to the widget
+        markDirty(ctx, widget, true);
+        r.set(x, y, r.width, r.height);
+        syncTree(ctx, widget);
+        markDirty(ctx, widget, true);
+    }
+
+    void shiftOrigin(Widget *widget, int32_t dx, int32_t dy) {
+        // The upper left corner has moved, the children keep their screen positions
+        for (Widget *child : widget->mChildren) {
+            Rect &r = child->mRect;
+            r.set(r.top.x - dx, r.top.y - dy, r.width, r.height);
+        }
+    }
+
     Widget *setParent(Context &ctx, Widget *child, WidgetHandle parentId) {
         Widget *parent{ nullptr };
         if (parentId.mId == 0) {
@@ -125,72 +310,96 @@ namespace {
             return nullptr;
         }
 
+        // The rect of the child is given in screen coordinates
+        const Point2i origin = parent->getOrigin();
+        Rect &r = child->mRect;
+        r.set(r.top.x - origin.x, r.top.y - origin.y, r.width, r.height);
+        child->mParent = parent;
         parent->mChildren.emplace_back(child);
-        parent->mRect.mergeWithRect(child->mRect);
+        invalidateTree(ctx);
+        markDirty(ctx, parent, false);
+        if (parent->mParent == nullptr) {
+            parent->mRect.mergeWithRect(r);
+        } else {
+            // Merge in the space of the grandparent, the parent rect is relative to it
+            const Vec2i top = parent->mRect.top;
+            parent->mRect.mergeWithRect(offsetRect(r, Point2i(top.x, top.y)));
+            if (parent->mRect.top.x != top.x || parent->mRect.top.y != top.y) {
+                shiftOrigin(parent, parent->mRect.top.x - top.x, parent->mRect.top.y - top.y);
+            }
+        }
+        markDirty(ctx, parent, false);
+        markDirty(ctx, child, false);
 
         return parent;
     }
 
     Widget *createWidget(Context &ctx, WidgetHandle parentId, const Rect &rect, WidgetType type) {
-        auto *widget = new Widget;
-        widget->mHandle = WidgetHandle{ createHandle() };
+        Widget *widget = getWidgetPool(ctx).mWidgets.create();
         widget->mType = type;
         widget->mRect = rect;
         widget->mParent = setParent(ctx, widget, parentId);
         if (widget->mParent == nullptr) {
             assert(widget->mParent != nullptr);
-            delete widget;
-            widget = nullptr;
+            releaseWidget(ctx, widget);
+            return nullptr;
+        }
+        widget->mHandle = WidgetHandle{ ctx.mWidgets.insert(widget) };
+        if (widget->mParent->mLayout != nullptr && widget->mParent->mLayout->isContainer()) {
+            Layout::attach(ctx, widget);
         }
 
         return widget;
     }
 
-    void deleteKeyFromText(Context &ctx) {
-        ctx.mFocus->mText.erase(ctx.mFocus->mText.size() - 1);
+    void deleteKeyFromText(Context &ctx, Widget *focus) {
+        if (focus->mText.empty()) {
+            return;
+        }
+        focus->mText.erase(focus->mText.size() - 1);
+        markDirty(ctx, focus, false);
     }
 
-    void appendKeyToText(Context &ctx, char *buffer) {
+    void appendKeyToText(Context &ctx, Widget *focus, char *buffer) {
         if (buffer == nullptr) {
             TINYUI_TRACE("appendKeyToText: buffer is nullptr");
             return;
         }
-        if (ctx.mFocus == nullptr) {
-            TINYUI_TRACE("appendKeyToText: ctx.mFocus is nullptr");
-            return;
-        }
 
-        if (ctx.mFocus->mKeyInputType == KeyInputType::Numeric) {
+        if (focus->mKeyInputType == KeyInputType::Numeric) {
             if (buffer[0] < '0' || buffer[0] > '9') {
                 return;
             }
         }
         
-        ctx.mFocus->mText.append(buffer);
+        focus->mText.append(buffer);
+        markDirty(ctx, focus, false);
     }
 
-    void handleInputField(Context &ctx, EventPayload *eventPayload) {
+    void handleInputField(Context &ctx, Widget *focus, EventPayload *eventPayload) {
         char buffer[2] = {
             static_cast<char>(eventPayload->payload[0]),
             '\0'
         };
-        if (buffer[0] == SDLK_BACKSPACE) {
-            deleteKeyFromText(ctx);
+        if (buffer[0] == BackspaceKey) {
+            deleteKeyFromText(ctx, focus);
         } else {
-            appendKeyToText(ctx, buffer);
+            appendKeyToText(ctx, focus, buffer);
         }
     }
 } // namespace
 
 void eventDispatcher(Context &ctx, int32_t eventId, EventPayload *eventPayload) {
-    if (ctx.mFocus == nullptr) {
+    // The focused widget may have been cleared, the stale handle resolves to nullptr then
+    Widget *focus = ctx.mWidgets.get(ctx.mFocus);
+    if (focus == nullptr) {
         return;
     }
 
     if (eventId == Events::KeyDownEvent) {
         if (eventPayload != nullptr) {
-            if (ctx.mFocus->mType == WidgetType::InputField) {
-                handleInputField(ctx, eventPayload);
+            if (focus->mType == WidgetType::InputField) {
+                handleInputField(ctx, focus, eventPayload);
             }
         }
     }
@@ -216,27 +425,43 @@ Widget *Widgets::findWidget(WidgetHandle id, Widget *root) {
         return nullptr;
     }
 
-    if (root->mHandle.mId == id.mId) {
-        return root;
+    const auto &ctx = TinyUi::getContext();
+    if (id.mId == WidgetHandle::RootItem) {
+        return ctx.mRoot == root ? root : nullptr;
     }
 
-    for (size_t i=0; i<root->mChildren.size(); ++i) {
-        Widget *child = root->mChildren[i];
-        if (child == nullptr) {
-            continue;
-        }
-        if (child->mHandle.mId == id.mId) {
-            return child;
-        }
-        Widget *foundWidget = findWidget(id, child);
-        if (foundWidget != nullptr) {
-            return foundWidget;
+    Widget *widget = ctx.mWidgets.get(id);
+    if (widget == nullptr || root == ctx.mRoot) {
+        return widget;
+    }
+
+    // Only widgets in the subtree of the given root will be found
+    for (const Widget *current = widget; current != nullptr; current = current->mParent) {
+        if (current == root) {
+            return widget;
         }
     }
 
     return nullptr;
 }
 
+static void findSelectedWidget(int x, int y, Widget *currentChild, const Point2i &origin, Widget **found) {
+    const Rect r = offsetRect(currentChild->mRect, origin);
+    if (!r.isIn(x, y)) {
+        return;
+    }
+
+    *found = currentChild;
+    const Point2i childOrigin = currentChild->mParent != nullptr ? Point2i(r.top.x, r.top.y) : Point2i(0, 0);
+    for (auto &child : currentChild->mChildren) {
+        if (!child->isEnabled()) {
+            continue;
+        }
+
+        findSelectedWidget(x, y, child, childOrigin, found);
+    }
+}
+
 void Widgets::findSelectedWidget(int x, int y, Widget *currentChild, Widget **found) {
     if (found == nullptr) {
         return;
@@ -246,23 +471,462 @@ void Widgets::findSelectedWidget(int x, int y, Widget *currentChild, Widget **fo
         return;
     }
 
-    if (currentChild->mRect.isIn(x, y)) {
-        *found = currentChild;
-        for ( auto &child : currentChild->mChildren) {
-            if (!child->isEnabled()) {
-                continue;
-            }
+    tinyui::findSelectedWidget(x, y, currentChild, getParentOrigin(currentChild), found);
+}
+
+void WidgetTree::rebuild(Widget *root) {
+    mRects.clear();
+    mBounds.clear();
+    mFlags.clear();
+    mTypes.clear();
+    mParents.clear();
+    mSubtreeEnd.clear();
+    mWidgets.clear();
+    if (root != nullptr) {
+        add(root, -1);
+    }
+    mOrigins.resize(mWidgets.size());
+    mValid = true;
+    rebuildGrid();
+    mBoundsValid = false;
+    updateBounds();
+}
+
+void WidgetTree::updateBounds() {
+    if (mBoundsValid) {
+        return;
+    }
+
+    // The children follow their parent in pre-order, so one backward pass merges all subtrees
+    mBounds.assign(mRects.begin(), mRects.end());
+    for (size_t i = mBounds.size(); i-- > 1;) {
+        const int32_t parent = mParents[i];
+        if (parent < 0) {
+            continue;
+        }
+
+        const Rect &child = mBounds[i];
+        if (child.width <= 0 || child.height <= 0) {
+            continue;
+        }
+
+        // The bounds of the child are relative to the parent, the root has no offset
+        const Point2i origin = mParents[parent] != -1 ? Point2i(mRects[parent].top.x, mRects[parent].top.y) : Point2i(0, 0);
+        mBounds[parent] = mergeRects(mBounds[parent], offsetRect(child, origin));
+    }
+    mBoundsValid = true;
+}
+
+void WidgetTree::settle(uint64_t frame) {
+    mFrame = frame;
+    if (!mGridValid) {
+        rebuildGrid();
+        return;
+    }
+
+    // A subtree, which is still dragged around, would be written into the grid with every move
+    for (size_t i = 0; i < mMoved.size();) {
+        if (mMoved[i].mFrame + 2 <= frame) {
+            updateGrid(mMoved[i].mIndex);
+            mMoved[i] = mMoved.back();
+            mMoved.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+Point2i WidgetTree::getOrigin(uint32_t index) const {
+    Point2i origin(0, 0);
+    for (int32_t i = static_cast<int32_t>(index); i != -1 && mParents[i] != -1; i = mParents[i]) {
+        origin.set(origin.x + mRects[i].top.x, origin.y + mRects[i].top.y);
+    }
+
+    return origin;
+}
+
+Rect WidgetTree::getScreenRect(uint32_t index) const {
+    const int32_t parent = mParents[index];
+    return offsetRect(mRects[index], parent != -1 ? getOrigin(parent) : Point2i(0, 0));
+}
+
+Rect WidgetTree::getScreenBounds(uint32_t index) const {
+    const int32_t parent = mParents[index];
+    return offsetRect(mBounds[index], parent != -1 ? getOrigin(parent) : Point2i(0, 0));
+}
+
+void WidgetTree::add(Widget *widget, int32_t parent) {
+    const auto index = static_cast<uint32_t>(mWidgets.size());
+    widget->mTreeIndex = index;
+    mRects.push_back(widget->mRect);
+    mBounds.push_back(widget->mRect);
+    mFlags.push_back(0);
+    mTypes.push_back(widget->mType);
+    mParents.push_back(parent);
+    mSubtreeEnd.push_back(index + 1);
+    mWidgets.push_back(widget);
+    sync(widget);
+
+    for (Widget *child : widget->mChildren) {
+        if (child != nullptr) {
+            add(child, static_cast<int32_t>(index));
+        }
+    }
+    mSubtreeEnd[index] = static_cast<uint32_t>(mWidgets.size());
+}
+
+void WidgetTree::sync(const Widget *widget) {
+    const uint32_t index = widget->mTreeIndex;
+    if (index >= mWidgets.size() || mWidgets[index] != widget) {
+        return;
+    }
+
+    const Rect &current = mRects[index];
+    const Rect &r = widget->mRect;
+    const bool moved = current.top.x != r.top.x || current.top.y != r.top.y;
+    const bool resized = current.width != r.width || current.height != r.height;
+    if (mValid && (moved || resized)) {
+        if (resized) {
+            mBoundsValid = false;
+        } else if (mBoundsValid) {
+            // The subtree moves as a whole, the bounds of the parents can only grow
+            Rect &bounds = mBounds[index];
+            bounds = offsetRect(bounds, Point2i(r.top.x - current.top.x, r.top.y - current.top.y));
+            growBounds(index);
+        }
+        mRects[index] = r;
+        if (mParents[index] == -1) {
+            // The children of the root do not depend on its position
+            mGrid.update(index, mGridRects[index], r);
+            mGridRects[index] = r;
+        } else {
+            markMoved(index, !resized);
+        }
+    } else {
+        mRects[index] = r;
+    }
+
+    uint8_t flags = 0;
+    if (widget->mEnabled) {
+        flags |= EnabledFlag;
+    }
+    if (widget->mFilledRect) {
+        flags |= FilledFlag;
+    }
+    if (widget->hasStyle(WidgetStyle::ClipChildren)) {
+        flags |= ClipFlag;
+    }
+    mFlags[index] = flags;
+}
+
+void WidgetTree::markMoved(uint32_t index, bool positionOnly) {
+    if (!mGridValid) {
+        return;
+    }
+
+    for (MovedSubtree &moved : mMoved) {
+        if (index >= moved.mIndex && index < mSubtreeEnd[moved.mIndex]) {
+            // Inside of a moved subtree the grid entries are not translated by one offset anymore
+            moved.mFrame = mFrame;
+            moved.mRigid = moved.mRigid && index == moved.mIndex && positionOnly;
+            return;
+        }
+    }
+
+    // The moved subtrees inside of the new one are merged into it
+    const size_t numMoved = mMoved.size();
+    std::erase_if(mMoved, [this, index](const MovedSubtree &moved) {
+        return moved.mIndex > index && moved.mIndex < mSubtreeEnd[index];
+    });
+    if (mMoved.size() >= MaxMovedSubtrees) {
+        mMoved.clear();
+        mGridValid = false;
+        return;
+    }
+    mMoved.push_back({ index, mFrame, positionOnly && numMoved == mMoved.size() });
+}
+
+void WidgetTree::growBounds(uint32_t index) {
+    for (int32_t child = static_cast<int32_t>(index), parent = mParents[index]; parent != -1;
+            child = parent, parent = mParents[parent]) {
+        const Rect &bounds = mBounds[child];
+        if (bounds.width <= 0 || bounds.height <= 0) {
+            return;
+        }
+
+        const Point2i origin = mParents[parent] != -1 ? Point2i(mRects[parent].top.x, mRects[parent].top.y) : Point2i(0, 0);
+        const Rect merged = mergeRects(mBounds[parent], offsetRect(bounds, origin));
+        const Rect &current = mBounds[parent];
+        if (merged.top.x == current.top.x && merged.top.y == current.top.y &&
+                merged.width == current.width && merged.height == current.height) {
+            return;
+        }
+        mBounds[parent] = merged;
+    }
+}
+
+void WidgetTree::rebuildGrid() {
+    // The parents are visited first, so their origins are known for the children
+    mGridRects.resize(mRects.size());
+    for (size_t i = 0; i < mRects.size(); ++i) {
+        const int32_t parent = mParents[i];
+        const Point2i origin = parent != -1 ? mOrigins[parent] : Point2i(0, 0);
+        mGridRects[i] = offsetRect(mRects[i], origin);
+        mOrigins[i] = parent != -1 ? Point2i(mGridRects[i].top.x, mGridRects[i].top.y) : Point2i(0, 0);
+    }
+    mGrid.build(mGridRects);
+    mMoved.clear();
+    mGridValid = true;
+}
+
+void WidgetTree::updateGrid(uint32_t index) {
+    const int32_t parent = mParents[index];
+    mOrigins[index] = parent != -1 ? getOrigin(parent) : Point2i(0, 0);
+    for (uint32_t i = index; i < mSubtreeEnd[index]; ++i) {
+        // The origin of the subtree root is the one of its parent
+        const Point2i origin = i != index ? mOrigins[mParents[i]] : mOrigins[index];
+        const Rect r = offsetRect(mRects[i], origin);
+        mGrid.update(i, mGridRects[i], r);
+        mGridRects[i] = r;
+        mOrigins[i] = mParents[i] != -1 ? Point2i(r.top.x, r.top.y) : Point2i(0, 0);
+    }
+}
+
+bool WidgetTree::isMoved(uint32_t index) const {
+    for (const MovedSubtree &moved : mMoved) {
+        if (index >= moved.mIndex && index < mSubtreeEnd[moved.mIndex]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int32_t WidgetTree::findAt(int32_t x, int32_t y) const {
+    if (!mGridValid) {
+        return findInSubtree(0, x, y);
+    }
+
+    int32_t result = findInGrid(x, y, 0, 0, 0, static_cast<uint32_t>(size()));
+    for (const MovedSubtree &moved : mMoved) {
+        // A rigid subtree is still stored in the grid, only shifted by the move
+        int32_t index = -1;
+        if (moved.mRigid) {
+            const Rect r = getScreenRect(moved.mIndex);
+            const Rect &old = mGridRects[moved.mIndex];
+            index = findInGrid(x, y, r.top.x - old.top.x, r.top.y - old.top.y, moved.mIndex, mSubtreeEnd[moved.mIndex]);
+        } else {
+            index = findInSubtree(moved.mIndex, x, y);
+        }
+        result = std::max(result, index);
+    }
+
+    return result;
+}
+
+int32_t WidgetTree::findInGrid(int32_t x, int32_t y, int32_t dx, int32_t dy, uint32_t first, uint32_t end) const {
+    // Both lists are sorted by the pre-order index, the last hit in pre-order is the topmost one
+    // The root is never moved, so only the main pass starts at 0 and has to skip the moved subtrees
+    const bool isMovedSubtree = first != 0;
+    const std::vector<uint32_t> *cell = mGrid.getCell(x - dx, y - dy);
+    const std::vector<uint32_t> &large = mGrid.getLargeWidgets();
+    size_t numCell = cell != nullptr ? cell->size() : 0;
+    size_t numLarge = large.size();
+    while (numCell > 0 || numLarge > 0) {
+        uint32_t index = 0;
+        if (numLarge == 0 || (numCell > 0 && (*cell)[numCell - 1] > large[numLarge - 1])) {
+            index = (*cell)[--numCell];
+        } else {
+            index = large[--numLarge];
+        }
+
+        if (index < first) {
+            break;
+        }
+        // The grid rect is the current screen rect shifted back by the move, a cheap first test
+        if (index >= end || !mGridRects[index].isIn(x - dx, y - dy) || (!isMovedSubtree && isMoved(index))) {
+            continue;
+        }
+        if (isHit(index, x, y)) {
+            return static_cast<int32_t>(index);
+        }
+    }
+
+    return -1;
+}
+
+int32_t WidgetTree::findInSubtree(uint32_t index, int32_t x, int32_t y) const {
+    if (index >= size() || !isHit(index, x, y)) {
+        return -1;
+    }
+
+    // Only the hit widgets are entered, the last hit in pre-order is the topmost one
+    uint32_t result = index;
+    const int32_t parent = mParents[index];
+    const Point2i origin = parent != -1 ? getOrigin(parent) : Point2i(0, 0);
+    mOrigins[index] = parent != -1 ? Point2i(origin.x + mRects[index].top.x, origin.y + mRects[index].top.y) : Point2i(0, 0);
+    for (uint32_t i = index + 1; i < mSubtreeEnd[index];) {
+        const Point2i &parentOrigin = mOrigins[mParents[i]];
+        const Rect &r = mRects[i];
+        if ((mFlags[i] & EnabledFlag) == 0 || !r.isIn(x - parentOrigin.x, y - parentOrigin.y)) {
+            i = mSubtreeEnd[i];
+            continue;
+        }
+
+        result = i;
+        mOrigins[i] = Point2i(parentOrigin.x + r.top.x, parentOrigin.y + r.top.y);
+        ++i;
+    }
+
+    return static_cast<int32_t>(result);
+}
+
+bool WidgetTree::isHit(uint32_t index, int32_t x, int32_t y) const {
+    // A widget can only be hit inside of all its parents, the enabled state of the root is ignored
+    const int32_t parent = mParents[index];
+    Point2i origin = parent != -1 ? getOrigin(parent) : Point2i(0, 0);
+    for (int32_t i = static_cast<int32_t>(index); i != -1; i = mParents[i]) {
+        if (!mRects[i].isIn(x - origin.x, y - origin.y)) {
+            return false;
+        }
+        if (i != 0 && (mFlags[i] & EnabledFlag) == 0) {
+            return false;
+        }
+
+        // Step to the origin of the grandparent, the root children are already relative to the screen
+        const int32_t next = mParents[i];
+        if (next != -1 && mParents[next] != -1) {
+            origin.set(origin.x - mRects[next].top.x, origin.y - mRects[next].top.y);
+        }
+    }
+
+    return true;
+}
+
+void WidgetGrid::build(const std::vector<Rect> &rects) {
+    // Keep the memory of the cells for the next build
+    for (std::vector<uint32_t> &cell : mCells) {
+        cell.clear();
+    }
+    mLarge.clear();
+    mCols = mRows = 0;
+    if (rects.empty()) {
+        mCells.clear();
+        return;
+    }
+
+    int32_t x0 = rects[0].top.x;
+    int32_t y0 = rects[0].top.y;
+    int32_t x1 = rects[0].bottom.x;
+    int32_t y1 = rects[0].bottom.y;
+    for (const Rect &r : rects) {
+        x0 = std::min(x0, r.top.x);
+        y0 = std::min(y0, r.top.y);
+        x1 = std::max(x1, r.bottom.x);
+        y1 = std::max(y1, r.bottom.y);
+    }
+
+    const int32_t extent = std::max(x1 - x0, y1 - y0) + 1;
+    mOrigin = Vec2i(x0, y0);
+    mCellSize = std::max(MinCellSize, (extent + MaxCellsPerAxis - 1) / MaxCellsPerAxis);
+    mCols = (x1 - x0) / mCellSize + 1;
+    mRows = (y1 - y0) / mCellSize + 1;
+    mCells.resize(static_cast<size_t>(mCols) * mRows);
+    for (size_t i = 0; i < rects.size(); ++i) {
+        insert(static_cast<uint32_t>(i), rects[i]);
+    }
+}
+
+void WidgetGrid::update(uint32_t index, const Rect &oldRect, const Rect &newRect) {
+    if (oldRect.top.x == newRect.top.x && oldRect.top.y == newRect.top.y &&
+            oldRect.bottom.x == newRect.bottom.x && oldRect.bottom.y == newRect.bottom.y) {
+        return;
+    }
+
+    remove(index, oldRect);
+    insert(index, newRect);
+}
+
+const std::vector<uint32_t> *WidgetGrid::getCell(int32_t x, int32_t y) const {
+    const int32_t cx = x - mOrigin.x;
+    const int32_t cy = y - mOrigin.y;
+    if (cx < 0 || cy < 0 || mCells.empty()) {
+        return nullptr;
+    }
+
+    const int32_t col = cx / mCellSize;
+    const int32_t row = cy / mCellSize;
+    if (col >= mCols || row >= mRows) {
+        return nullptr;
+    }
+
+    return &mCells[static_cast<size_t>(row) * mCols + col];
+}
+
+bool WidgetGrid::getCellRange(const Rect &r, int32_t &x0, int32_t &y0, int32_t &x1, int32_t &y1) const {
+    if (mCells.empty() || r.top.x < mOrigin.x || r.top.y < mOrigin.y) {
+        return false;
+    }
+
+    x0 = (r.top.x - mOrigin.x) / mCellSize;
+    y0 = (r.top.y - mOrigin.y) / mCellSize;
+    x1 = (r.bottom.x - mOrigin.x) / mCellSize;
+    y1 = (r.bottom.y - mOrigin.y) / mCellSize;
+    if (x1 < x0 || y1 < y0 || x1 >= mCols || y1 >= mRows) {
+        return false;
+    }
+
+    return (x1 - x0 + 1) * (y1 - y0 + 1) <= MaxCellsPerWidget;
+}
+
+void WidgetGrid::insert(uint32_t index, const Rect &r) {
+    int32_t x0, y0, x1, y1;
+    if (!getCellRange(r, x0, y0, x1, y1)) {
+        mLarge.insert(std::lower_bound(mLarge.begin(), mLarge.end(), index), index);
+        return;
+    }
 
-            if (child->mRect.isIn(x, y)) {
-                findSelectedWidget(x, y, child, found);
+    for (int32_t y = y0; y <= y1; ++y) {
+        for (int32_t x = x0; x <= x1; ++x) {
+            std::vector<uint32_t> &cell = mCells[static_cast<size_t>(y) * mCols + x];
+            cell.insert(std::lower_bound(cell.begin(), cell.end(), index), index);
+        }
+    }
+}
+
+void WidgetGrid::remove(uint32_t index, const Rect &r) {
+    int32_t x0, y0, x1, y1;
+    if (!getCellRange(r, x0, y0, x1, y1)) {
+        auto it = std::lower_bound(mLarge.begin(), mLarge.end(), index);
+        if (it != mLarge.end() && *it == index) {
+            mLarge.erase(it);
+        }
+        return;
+    }
+
+    for (int32_t y = y0; y <= y1; ++y) {
+        for (int32_t x = x0; x <= x1; ++x) {
+            std::vector<uint32_t> &cell = mCells[static_cast<size_t>(y) * mCols + x];
+            auto it = std::lower_bound(cell.begin(), cell.end(), index);
+            if (it != cell.end() && *it == index) {
+                cell.erase(it);
             }
         }
     }
 }
 
+const WidgetTree *Widgets::getWidgetTree() {
+    auto &ctx = TinyUi::getContext();
+    if (ctx.mRoot == nullptr) {
+        return nullptr;
+    }
+
+    return &getValidWidgetTree(ctx);
+}
+
 WidgetHandle Widgets::label(WidgetHandle parentId, const char *text, const Rect &rect, Alignment alignment) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -285,14 +949,15 @@ static int inputHandler(WidgetHandle id, void *instance) {
     }
 
     auto *ctx = static_cast<Context *>(instance);
-    ctx->mFocus = Widgets::findWidget(id, ctx->mRoot);
+    const Widget *widget = Widgets::findWidget(id, ctx->mRoot);
+    ctx->mFocus = widget != nullptr ? widget->mHandle : WidgetHandle{};
 
     return ResultOk;
 }
 
 WidgetHandle Widgets::inputText(WidgetHandle parentId, const Rect &rect, Alignment alignment, KeyInputType type, const char *defaultText) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -308,13 +973,14 @@ WidgetHandle Widgets::inputText(WidgetHandle parentId, const Rect &rect, Alignme
     }
 
     widget->mCallback = new CallbackI(inputHandler, (void *)&ctx, Events::MouseButtonDownEvent);
+    widget->mCallback->incRef();
 
     return widget->mHandle;
 }
 
 WidgetHandle Widgets::textButton(WidgetHandle parentId, const char *text, const Rect &rect, Alignment alignment, CallbackI *callback) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -337,7 +1003,7 @@ WidgetHandle Widgets::textButton(WidgetHandle parentId, const char *text, const
 
 WidgetHandle Widgets::imageButton(WidgetHandle parentId, const char *image, const Rect &rect, CallbackI *callback) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -360,7 +1026,7 @@ WidgetHandle Widgets::imageButton(WidgetHandle parentId, const char *image, cons
 
 WidgetHandle Widgets::box(WidgetHandle parentId, const Rect &rect, bool filled) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -376,7 +1042,7 @@ WidgetHandle Widgets::box(WidgetHandle parentId, const Rect &rect, bool filled)
 
 WidgetHandle Widgets::imageBox(WidgetHandle parentId, const char* image, const Rect& rect, bool filled) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -394,7 +1060,7 @@ WidgetHandle Widgets::imageBox(WidgetHandle parentId, const char* image, const R
 
 WidgetHandle Widgets::panel(WidgetHandle parentId, const char *title, const Rect &rect, CallbackI *callback) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -404,7 +1070,8 @@ WidgetHandle Widgets::panel(WidgetHandle parentId, const char *title, const Rect
 }
 
 static int onTreeViewItemClicked(WidgetHandle id, void *data) {
-    Widget *treeView = Widgets::findWidget(id, TinyUi::getContext().mRoot);
+    auto &ctx = TinyUi::getContext();
+    Widget *treeView = Widgets::findWidget(id, ctx.mRoot);
     if (treeView == nullptr) {
         return ErrorCode;
     }
@@ -415,6 +1082,8 @@ static int onTreeViewItemClicked(WidgetHandle id, void *data) {
             continue;
         }
         child->mEnabled = !child->mEnabled;
+        syncTree(ctx, child);
+        markDirty(ctx, child, true);
     }
 
 #ifdef _DEBUG
@@ -425,7 +1094,7 @@ static int onTreeViewItemClicked(WidgetHandle id, void *data) {
 
 WidgetHandle Widgets::treeView(WidgetHandle parentId, const char *title, const Rect &rect) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -449,7 +1118,7 @@ WidgetHandle Widgets::treeView(WidgetHandle parentId, const char *title, const R
 
 WidgetHandle Widgets::treeItem(WidgetHandle parentItemId, const char *text) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -462,10 +1131,11 @@ WidgetHandle Widgets::treeItem(WidgetHandle parentItemId, const char *text) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
     
-    const auto &parentRect = parentWidget->mRect;    
+    const Rect parentRect = parentWidget->getScreenRect();
     const int32_t margin = ctx.mStyle.mMargin;
+    // The parent rect grows with every item, so the height of the items is taken from the first one
     const int32_t w = parentRect.width;
-    const int32_t h = parentRect.height;
+    const int32_t h = parentWidget->mChildren.empty() ? parentRect.height : parentWidget->mChildren.front()->mRect.height;
     const size_t numChildren = parentWidget->mChildren.size() + 1;
     const Rect rect(parentRect.top.x + margin, parentRect.top.y + static_cast<int32_t>(numChildren) * margin +
         static_cast<int32_t>(numChildren) * h, w, h);
@@ -484,7 +1154,7 @@ WidgetHandle Widgets::treeItem(WidgetHandle parentItemId, const char *text) {
 
 WidgetHandle Widgets::progressBar(WidgetHandle parentId, const Rect &rect, int fillRate, CallbackI *callback) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -500,8 +1170,10 @@ WidgetHandle Widgets::progressBar(WidgetHandle parentId, const Rect &rect, int f
     child->mCallback = callback;
     EventPayload payload;
     payload.type = EventDataType::FillState;
+    memcpy(payload.payload, &state, sizeof(FilledState));
     memcpy(child->mContent, &payload, sizeof(EventPayload));
     if (callback != nullptr) {
+        callback->incRef();
         callback->mInstance = child;
         ctx.mUpdateCallbackList.push_back(callback);
     }
@@ -511,7 +1183,7 @@ WidgetHandle Widgets::progressBar(WidgetHandle parentId, const Rect &rect, int f
 
 WidgetHandle Widgets::checkBox(WidgetHandle parentId, const char *text, const Rect &rect, bool checked, CallbackI *callback) {
     auto &ctx = TinyUi::getContext();
-    if (ctx.mBackendCtx == nullptr) {
+    if (ctx.mBackend == nullptr) {
         return WidgetHandle{WidgetHandle::InvalidId};
     }
 
@@ -524,47 +1196,96 @@ WidgetHandle Widgets::checkBox(WidgetHandle parentId, const char *text, const Re
         return WidgetHandle{WidgetHandle::InvalidId};
     }
     child->mText.assign(text);
-    child->mCheckBoxContext = new CheckBoxContext;
+    child->mCheckBoxContext = getWidgetPool(ctx).mCheckBoxes.create();
     child->mCheckBoxContext->mChecked = checked;
 
     return child->mHandle;
 }
 
-static void render(Context &ctx, const Widget *currentWidget) {
-    if (currentWidget == nullptr) {
+WidgetHandle Widgets::statsOverlay(WidgetHandle parentId, const Rect &rect) {
+    auto &ctx = TinyUi::getContext();
+    if (ctx.mBackend == nullptr) {
+        return WidgetHandle{WidgetHandle::InvalidId};
+    }
+
+    if (ctx.mRoot == nullptr) {
+        return WidgetHandle{WidgetHandle::InvalidId};
+    }
+
+    // Only one overlay is supported, the previous one gets removed
+    if (ctx.mWidgets.get(ctx.mStatsOverlay) != nullptr) {
+        clearItem(ctx.mStatsOverlay, true);
+    }
+    ctx.mStatsOverlay = WidgetHandle{};
+
+    Widget *widget = createWidget(ctx, parentId, rect, WidgetType::StatsOverlay);
+    if (widget == nullptr) {
+        return WidgetHandle{WidgetHandle::InvalidId};
+    }
+    widget->mAlignment = Alignment::Left;
+    ctx.mStatsOverlay = widget->mHandle;
+
+    return widget->mHandle;
+}
+
+void Widgets::updateStatsOverlay(const DirtyRegion &damage) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = ctx.mWidgets.get(ctx.mStatsOverlay);
+    if (widget == nullptr) {
         return;
     }
 
-    if (!currentWidget->mEnabled) {
+    // A frame which only redrew the overlay would show its own statistics in the next refresh
+    const Rect r = widget->getScreenRect();
+    if (damage.isPartial() && r.isIn(damage.mBounds.top.x, damage.mBounds.top.y) &&
+            r.isIn(damage.mBounds.bottom.x, damage.mBounds.bottom.y)) {
         return;
     }
 
+    const FrameStats &stats = ctx.mLastFrameStats;
+    char text[256] = {};
+    snprintf(text, sizeof(text),
+        "draw calls: %zu\nrects: %zu texts: %zu images: %zu\ntextures: %zu uploads: %zu\n"
+        "glyphs: %zu text cache: %zu/%zu\nwidgets: %zu culled: %zu",
+        stats.mNumDrawCalls, stats.mNumRects, stats.mNumTexts, stats.mNumImages,
+        stats.mNumTexturesCreated, stats.mNumTextureUploads, stats.mNumGlyphHits,
+        stats.mNumTextCacheHits, stats.mNumTextCacheHits + stats.mNumTextCacheMisses,
+        stats.mNumWidgetsVisited, stats.mNumWidgetsCulled);
+    if (widget->mText != text) {
+        widget->mText.assign(text);
+        markDirty(ctx, widget, false);
+    }
+}
+
+static void render(Context &ctx, RenderBackendI &backend, const WidgetTree &tree, size_t index, const Rect &r) {
+    const Widget *currentWidget = tree.mWidgets[index];
+    const bool filled = (tree.mFlags[index] & WidgetTree::FilledFlag) != 0;
+
     // Render the widget
-    const Rect &r = currentWidget->mRect;
-    switch( currentWidget->mType) {
+    switch (tree.mTypes[index]) {
         case WidgetType::Button:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
                 if (currentWidget->mImage != nullptr) {
-                    Renderer::drawImage(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mImage);
+                    backend.drawImage(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mImage);
                 }
                 if (!currentWidget->mText.empty()) {
                     const Color4 fg = ctx.mStyle.mTextColor;
                     const Color4 bg = ctx.mStyle.mBg;
-                    Renderer::drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
-                        currentWidget->mRect, fg, bg, currentWidget->mAlignment);
+                    backend.drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
+                        r, fg, bg, currentWidget->mAlignment);
                 }
             }
             break;
 
             case WidgetType::TreeView:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, false, ctx.mStyle.mFg);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, false, ctx.mStyle.mFg);
                 if (!currentWidget->mText.empty()) {
                     const Color4 fg = ctx.mStyle.mTextColor;
                     const Color4 bg = ctx.mStyle.mBg;
-                    Renderer::drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
-                        currentWidget->mRect, fg, bg, currentWidget->mAlignment);
+                    backend.drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
+                        r, fg, bg, currentWidget->mAlignment);
                 }
             }
             break;
@@ -574,21 +1295,21 @@ static void render(Context &ctx, const Widget *currentWidget) {
                 if (!currentWidget->mText.empty()) {
                     const Color4 fg = ctx.mStyle.mTextColor;
                     const Color4 bg = ctx.mStyle.mBg;
-                    Renderer::drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
-                        currentWidget->mRect, fg, bg, currentWidget->mAlignment);
+                    backend.drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont, 
+                        r, fg, bg, currentWidget->mAlignment);
                 }
             } 
             break;
 
         case WidgetType::Panel:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, false, ctx.mStyle.mBorder);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, false, ctx.mStyle.mBorder);
             }
             break;
 
         case WidgetType::ProgressBar:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
                 auto *payload = reinterpret_cast<EventPayload *>(currentWidget->mContent);
                 if (payload == nullptr) {
                     break;
@@ -602,7 +1323,7 @@ static void render(Context &ctx, const Widget *currentWidget) {
                 if (fillRate != 0) {
                     width = r.width * fillRate / 100;
                 }
-                Renderer::drawRect(ctx, r.top.x, r.top.y, width, r.height, true, ctx.mStyle.mTextColor);                       
+                backend.drawRect(ctx, r.top.x, r.top.y, width, r.height, true, ctx.mStyle.mTextColor);                       
             } 
             break;
 
@@ -612,15 +1333,15 @@ static void render(Context &ctx, const Widget *currentWidget) {
                     int size = r.height/2;
                     Rect checkBoxRect(r.top.x, r.top.y + (r.height - size)/2, size, size);
                     if (currentWidget->mCheckBoxContext->mChecked) {
-                        Renderer::drawRect(ctx, checkBoxRect.top.x, checkBoxRect.top.y, checkBoxRect.width, checkBoxRect.height, true, ctx.mStyle.mFg);
+                        backend.drawRect(ctx, checkBoxRect.top.x, checkBoxRect.top.y, checkBoxRect.width, checkBoxRect.height, true, ctx.mStyle.mFg);
                     } else {
-                        Renderer::drawRect(ctx, checkBoxRect.top.x, checkBoxRect.top.y, checkBoxRect.width, checkBoxRect.height, true, ctx.mStyle.mBg);
+                        backend.drawRect(ctx, checkBoxRect.top.x, checkBoxRect.top.y, checkBoxRect.width, checkBoxRect.height, true, ctx.mStyle.mBg);
                     }
                     if (!currentWidget->mText.empty()) {
                         const Color4 fg = ctx.mStyle.mTextColor;
                         const Color4 bg = ctx.mStyle.mBg;
                         Rect textRect(checkBoxRect.top.x + checkBoxRect.width + 5, r.top.y, r.width - checkBoxRect.width - 5, r.height);
-                        Renderer::drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont,
+                        backend.drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont,
                                 textRect, fg, bg, currentWidget->mAlignment);                
                     }
                 }
@@ -629,13 +1350,32 @@ static void render(Context &ctx, const Widget *currentWidget) {
 
         case WidgetType::InputField:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
-                Renderer::drawRect(ctx, r.top.x+2, r.top.y+2, r.width-4, r.height-4, true, ctx.mStyle.mBorder);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mFg);
+                backend.drawRect(ctx, r.top.x+2, r.top.y+2, r.width-4, r.height-4, true, ctx.mStyle.mBorder);
                 if (!currentWidget->mText.empty()) {
                     const Color4 fg = ctx.mStyle.mTextColor;
                     const Color4 bg = ctx.mStyle.mBg;
-                    Renderer::drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont,
-                            currentWidget->mRect, fg, bg, currentWidget->mAlignment);                
+                    backend.drawText(ctx, currentWidget->mText.c_str(), currentWidget->mText.length(), ctx.mDefaultFont,
+                            r, fg, bg, currentWidget->mAlignment);                
+                }
+            }
+            break;
+
+        case WidgetType::StatsOverlay:
+            {
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, true, ctx.mStyle.mBg);
+                const int32_t lineHeight = ctx.mStyle.mFont.mSize + 4;
+                const std::string &text = currentWidget->mText;
+                Rect lineRect(r.top.x, r.top.y, r.width, lineHeight);
+                for (size_t start = 0; start < text.size() && lineRect.top.y < r.top.y + r.height;) {
+                    size_t end = text.find('\n', start);
+                    if (end == std::string::npos) {
+                        end = text.size();
+                    }
+                    backend.drawText(ctx, text.c_str() + start, end - start, ctx.mDefaultFont, lineRect,
+                        ctx.mStyle.mTextColor, ctx.mStyle.mBg, currentWidget->mAlignment);
+                    lineRect.set(lineRect.top.x, lineRect.top.y + lineHeight, lineRect.width, lineHeight);
+                    start = end + 1;
                 }
             }
             break;
@@ -643,31 +1383,104 @@ static void render(Context &ctx, const Widget *currentWidget) {
         case WidgetType::RootContainer:
         case WidgetType::Box:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mFilledRect, ctx.mStyle.mBorder);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, filled, ctx.mStyle.mBorder);
             }
             break;
 
         case WidgetType::ImageBox:
             {
-                Renderer::drawRect(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mFilledRect, ctx.mStyle.mBorder);
+                backend.drawRect(ctx, r.top.x, r.top.y, r.width, r.height, filled, ctx.mStyle.mBorder);
                 if (currentWidget->mImage != nullptr) {
-                    Renderer::drawImage(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mImage);
+                    backend.drawImage(ctx, r.top.x, r.top.y, r.width, r.height, currentWidget->mImage);
                 }
             }
             break;
     }
-
-    for (auto &child : currentWidget->mChildren) {
-        render(ctx, child);
-    }
 }
 
 void Widgets::renderWidgets() {
+    TINYUI_PROFILE_SCOPE("render_widgets");
     auto &ctx = TinyUi::getContext();
-    if (ctx.mRoot == nullptr) {
+    if (ctx.mRoot == nullptr || ctx.mBackend == nullptr) {
         return;
     }
-    render(ctx, ctx.mRoot);
+
+    WidgetTree &tree = getValidWidgetTree(ctx);
+    tree.updateBounds();
+
+    // Only widgets inside the surface and the damaged area need to be drawn
+    Rect visible(std::numeric_limits<int32_t>::min() / 2, std::numeric_limits<int32_t>::min() / 2,
+        std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max());
+    if (int32_t w = 0, h = 0; ctx.mBackend->getSurfaceInfo(ctx, w, h) == ResultOk) {
+        visible.set(0, 0, w, h);
+    }
+    if (ctx.mDirtyRegion.isPartial()) {
+        visible = getIntersection(visible, ctx.mDirtyRegion.mBounds);
+    }
+
+    // The parents are visited before their children, so the screen origins are passed down. The
+    // rects are relative to the parent, so the clip rect is moved into the space of the parent instead.
+    std::vector<ClipEntry> clipStack;
+    std::vector<OriginEntry> originStack;
+    Point2i origin(0, 0);
+    Rect localClip = visible;
+    size_t numVisited = 0;
+    size_t numCulled = 0;
+    const size_t numWidgets = tree.size();
+    for (size_t i = 0; i < numWidgets;) {
+        bool changed = false;
+        while (!clipStack.empty() && i >= clipStack.back().mEnd) {
+            clipStack.pop_back();
+            ctx.mBackend->setClipRect(ctx, clipStack.empty() ? nullptr : &clipStack.back().mRect);
+            changed = true;
+        }
+        while (!originStack.empty() && i >= originStack.back().mEnd) {
+            originStack.pop_back();
+            changed = true;
+        }
+        if (changed) {
+            origin = originStack.empty() ? Point2i(0, 0) : originStack.back().mOrigin;
+            localClip = offsetRect(clipStack.empty() ? visible : clipStack.back().mRect, Point2i(-origin.x, -origin.y));
+        }
+
+        if ((tree.mFlags[i] & WidgetTree::EnabledFlag) == 0) {
+            // Disabled widgets will hide their children as well
+            i = tree.mSubtreeEnd[i];
+            continue;
+        }
+
+        if (!isIntersecting(tree.mBounds[i], localClip)) {
+            numCulled += tree.mSubtreeEnd[i] - i;
+            i = tree.mSubtreeEnd[i];
+            continue;
+        }
+
+        // The bounds of a leaf are its rect, so only containers need a second test
+        const bool isLeaf = tree.mSubtreeEnd[i] == i + 1;
+        if (isLeaf || isIntersecting(tree.mRects[i], localClip)) {
+            render(ctx, *ctx.mBackend, tree, i, offsetRect(tree.mRects[i], origin));
+            ++numVisited;
+        } else {
+            ++numCulled;
+        }
+        if (!isLeaf) {
+            const Rect r = offsetRect(tree.mRects[i], origin);
+            originStack.push_back({ tree.mParents[i] != -1 ? Point2i(r.top.x, r.top.y) : Point2i(0, 0), tree.mSubtreeEnd[i] });
+            if ((tree.mFlags[i] & WidgetTree::ClipFlag) != 0) {
+                const Rect &clip = clipStack.empty() ? visible : clipStack.back().mRect;
+                clipStack.push_back({ getIntersection(r, clip), tree.mSubtreeEnd[i] });
+                ctx.mBackend->setClipRect(ctx, &clipStack.back().mRect);
+            }
+            origin = originStack.back().mOrigin;
+            localClip = offsetRect(clipStack.empty() ? visible : clipStack.back().mRect, Point2i(-origin.x, -origin.y));
+        }
+        ++i;
+    }
+    if (!clipStack.empty()) {
+        ctx.mBackend->setClipRect(ctx, nullptr);
+    }
+    ctx.mFrameStats.mNumWidgetsVisited += numVisited;
+    ctx.mFrameStats.mNumWidgetsCulled += numCulled;
 }
 
 void Widgets::onMouseButton(int x, int y, int eventType, MouseState state) {
@@ -676,15 +1489,19 @@ void Widgets::onMouseButton(int x, int y, int eventType, MouseState state) {
     assert(eventType < Events::NumEvents);
 
     if (ctx.mRoot == nullptr) {
+        postEvent(ctx, eventType, WidgetHandle{}, x, y, state);
         return;
     }
 
-    Widget *found{nullptr};
-    findSelectedWidget(x, y, ctx.mRoot, &found);
+    const WidgetTree &tree = getValidWidgetTree(ctx);
+    const int32_t index = tree.findAt(x, y);
+    Widget *found = index != -1 ? tree.mWidgets[index] : nullptr;
+    postEvent(ctx, eventType, found != nullptr ? found->mHandle : WidgetHandle{}, x, y, state);
     if (found != nullptr) {
         if (found->mType == WidgetType::CheckBox) {
             if (eventType == Events::MouseButtonDownEvent) {
                 found->mCheckBoxContext->mChecked = !found->mCheckBoxContext->mChecked;
+                markDirty(ctx, found, false);
             }
         }
 
@@ -709,18 +1526,26 @@ void Widgets::onMouseMove(int x, int y, int eventType, MouseState state) {
 
     auto &ctx = TinyUi::getContext();
     if (ctx.mRoot == nullptr) {
+        postEvent(ctx, eventType, WidgetHandle{}, x, y, state);
         return;
     }
 
-    Widget *found{nullptr};
-    findSelectedWidget(x, y, ctx.mRoot, &found);
-    if (found == nullptr) {
-        return;
-    }
+    const WidgetTree &tree = getValidWidgetTree(ctx);
+    const int32_t index = tree.findAt(x, y);
+    const WidgetHandle hovered = index != -1 ? tree.mWidgets[index]->mHandle : WidgetHandle{};
+    postEvent(ctx, eventType, hovered, x, y, state);
 
-    if (found->mCallback != nullptr) {
-        if (found->mCallback->mfuncCallback[eventType] != nullptr) {
-            found->mCallback->mfuncCallback[eventType](found->mHandle, found->mCallback->mInstance);
+    // The callbacks may change the tree, so the widgets are looked up by their handles
+    if (hovered.mId != ctx.mHovered.mId) {
+        const WidgetHandle left = ctx.mHovered;
+        ctx.mHovered = hovered;
+        if (left.isValid()) {
+            postEvent(ctx, Events::MouseLeaveEvent, left, x, y, state);
+            fireEvent(findWidget(left, ctx.mRoot), Events::MouseLeaveEvent);
+        }
+        if (hovered.isValid()) {
+            postEvent(ctx, Events::MouseHoverEvent, hovered, x, y, state);
+            fireEvent(findWidget(hovered, ctx.mRoot), Events::MouseHoverEvent);
         }
     }
 }
@@ -741,6 +1566,14 @@ void Widgets::onKey(const char *key, bool isDown) {
         eventId = Events::KeyUpEvent;
         eventPayload.type = EventDataType::KeyUpState;
     }
+
+    if (ctx.mEventBus != nullptr) {
+        Event event;
+        event.mId = eventId;
+        event.mTarget = ctx.mWidgets.get(ctx.mFocus) != nullptr ? ctx.mFocus : WidgetHandle{};
+        event.mPayload = eventPayload;
+        ctx.mEventBus->post(event);
+    }
     eventDispatcher(ctx, eventId, &eventPayload);
 }
 
@@ -752,12 +1585,12 @@ void recursiveClear(Widget *current) {
     for (size_t i = 0; i < current->mChildren.size(); ++i) {
         recursiveClear(current->mChildren[i]);
     }
-
-    if (current->mCallback != nullptr) {
-        current->mCallback->decRef();
-        current->mCallback = nullptr;
-    }
-    delete current;
+    auto &ctx = TinyUi::getContext();
+    markDirty(ctx, current, false);
+    unregisterWidget(ctx, current);
+    invalidateTree(ctx);
+    releaseCallback(ctx, current);
+    releaseWidget(ctx, current);
 }
 
 void Widgets::clear() {
@@ -766,9 +1599,22 @@ void Widgets::clear() {
         return;
     }
 
-    Widget *current{ctx.mRoot};
-    recursiveClear(current);
+    // The callbacks can be shared, so release the references before all widgets are dropped at once
+    WidgetPool &pool = getWidgetPool(ctx);
+    pool.mWidgets.forEach([&ctx](Widget &widget) {
+        releaseCallback(ctx, &widget);
+    });
+    pool.mWidgets.reset();
+    pool.mCheckBoxes.reset();
+    pool.mLayouts.reset();
+
     ctx.mRoot = nullptr;
+    ctx.mFocus = WidgetHandle{};
+    ctx.mHovered = WidgetHandle{};
+    ctx.mWidgets.clear();
+    ctx.mDirtyLayouts.clear();
+    invalidateTree(ctx);
+    ctx.mDirtyRegion.invalidateAll();
     releaseImageCache(ctx);
 }
 
@@ -783,6 +1629,10 @@ bool Widgets::clearItem(WidgetHandle id, bool recursive) {
         return false;
     }
     
+    markDirty(ctx, widget, true);
+    if (widget->mLayoutPolicy == LayoutPolicy::Relative) {
+        Layout::invalidate(ctx, widget->mParent);
+    }
     auto &siblings = widget->mParent->mChildren;
     auto it = std::find(siblings.begin(), siblings.end(), widget);
     bool result{ false };
@@ -795,20 +1645,143 @@ bool Widgets::clearItem(WidgetHandle id, bool recursive) {
         for (size_t i = 0; i < widget->mChildren.size(); ++i) {
             recursiveClear(widget->mChildren[i]);
         }
+    } else {
+        // The children are not reachable anymore, the dirty area of the widget already covers them
+        releaseChildren(ctx, widget);
     }
-    delete widget;
+    unregisterWidget(ctx, widget);
+    invalidateTree(ctx);
+    releaseCallback(ctx, widget);
+    releaseWidget(ctx, widget);
     return result;
 }
 
+ret_code Widgets::setText(WidgetHandle id, const char *text) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    if (text == nullptr) {
+        text = "";
+    }
+
+    if (widget->mText == text) {
+        return ResultOk;
+    }
+
+    widget->mText.assign(text);
+    markDirty(ctx, widget, false);
+
+    return ResultOk;
+}
+
+ret_code Widgets::setRect(WidgetHandle id, const Rect &rect) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    if (widget->mLayout != nullptr) {
+        widget->mLayout->mWidth = rect.width;
+        widget->mLayout->mHeight = rect.height;
+        Layout::invalidate(ctx, widget);
+        if (widget->mLayoutPolicy == LayoutPolicy::Relative) {
+            // The position is owned by the container, only the preferred size is taken
+            return ResultOk;
+        }
+    }
+
+    // The rect is relative to the parent, the children follow the upper left corner
+    markDirty(ctx, widget, true);
+    widget->mRect.set(rect.top.x, rect.top.y, rect.width, rect.height);
+    syncTree(ctx, widget);
+    markDirty(ctx, widget, true);
+
+    return ResultOk;
+}
+
+ret_code Widgets::setStyle(WidgetHandle id, WidgetStyle style) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    widget->setStyle(style);
+    syncTree(ctx, widget);
+    markDirty(ctx, widget, true);
+
+    return ResultOk;
+}
+
+ret_code Widgets::setPosition(WidgetHandle id, int32_t x, int32_t y) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    if (widget->mParent == nullptr) {
+        return ErrorCode;
+    }
+
+    moveWidget(ctx, widget, x, y);
+
+    return ResultOk;
+}
+
+ret_code Widgets::setProgressValue(WidgetHandle id, int fillRate) {
+    auto &ctx = TinyUi::getContext();
+    Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    auto *payload = reinterpret_cast<EventPayload *>(widget->mContent);
+    if (widget->mType != WidgetType::ProgressBar || payload == nullptr) {
+        return ErrorCode;
+    }
+
+    clamp(0, 100, fillRate);
+    auto *state = reinterpret_cast<FilledState *>(payload->payload);
+    if (state->filledState != static_cast<uint32_t>(fillRate)) {
+        state->filledState = static_cast<uint32_t>(fillRate);
+        markDirty(ctx, widget, false);
+    }
+
+    return ResultOk;
+}
+
+ret_code Widgets::invalidate(WidgetHandle id) {
+    auto &ctx = TinyUi::getContext();
+    const Widget *widget = findWidget(id, ctx.mRoot);
+    if (widget == nullptr) {
+        return InvalidHandle;
+    }
+
+    syncTree(ctx, widget);
+    markDirty(ctx, widget, true);
+
+    return ResultOk;
+}
+
 void Widgets::setEnableState(WidgetHandle id, bool enabled) {
     auto &ctx = TinyUi::getContext();
     Widget *widget = findWidget(id, ctx.mRoot);
     if (widget != nullptr) {
+        if (widget->isEnabled() == enabled) {
+            return;
+        }
         if (enabled) {
             widget->enable();
         } else {
             widget->disable();
         }
+        syncTree(ctx, widget);
+        markDirty(ctx, widget, true);
     }
 }
 
@@ -828,7 +1801,7 @@ ret_code Widgets::setFocus(WidgetHandle id)  {
         return ErrorCode;
     }
 
-    ctx.mFocus = widget;
+    ctx.mFocus = widget->mHandle;
 
     return ResultOk;
 }
@@ -43,6 +43,7 @@ enum class WidgetType {
     TreeView,           ///< A treeview widget
     ProgressBar,        ///< A status bar widget
     CheckBox,           ///< A checkbox widget
+    StatsOverlay,       ///< A render statistics overlay widget
     Count               ///< The number of widgets
 };
 
@@ -54,6 +55,14 @@ enum class LayoutPolicy {
     Count               ///< The number of layouts
 };
 
+/// @brief This enum is used to describe the direction of a layout container.
+enum class LayoutDirection {
+    Invalid = -1,       ///< Not initialized
+    Horizontal,         ///< The children are stacked from left to right
+    Vertical,           ///< The children are stacked from top to bottom
+    Count               ///< The number of directions
+};
+
 /// @brief This enum is used to describe the input type from the keyboard.
 enum class KeyInputType {
     Invalid = -1,       ///< Not initialized
@@ -72,6 +81,7 @@ struct FilledState {
 enum class WidgetStyle {
     Invalid = -1,       ///< Not initialized
     BorderStyle,        ///< The widget has a border
+    ClipChildren,       ///< The children are clipped against the widget rectangle
     Count               ///< The number of widget styles
 };
 
@@ -83,13 +93,32 @@ struct CheckBoxContext {
     bool mChecked{false};   ///< The checked state of the checkbox.
 };
 
+/// @brief The layout state of a widget, used by layout containers and their relative children.
+struct LayoutNode {
+    LayoutDirection mDirection{LayoutDirection::Invalid};   ///< The stack direction, Invalid if the widget is no container.
+    int32_t         mSpacing{0};                            ///< The space between two children.
+    int32_t         mPadding{0};                            ///< The space between the border and the children.
+    int32_t         mWidth{0};                              ///< The preferred width.
+    int32_t         mHeight{0};                             ///< The preferred height.
+    int32_t         mFlex{0};                               ///< The share of the remaining space along the main axis.
+    int32_t         mMeasuredWidth{0};                      ///< The cached measured width.
+    int32_t         mMeasuredHeight{0};                     ///< The cached measured height.
+    bool            mDirty{false};                          ///< The measurement and the arrangement are outdated.
+
+    /// @brief Will return true if the node arranges its children.
+    /// @return true for a layout container.
+    bool isContainer() const {
+        return mDirection != LayoutDirection::Invalid;
+    }
+};
+
 /// @brief This struct contains all the data which is needed to describe a widget.
 struct Widget {
     WidgetHandle    mHandle{};                              ///< The unique id of the widget
     WidgetType      mType{WidgetType::Invalid};             ///< The type of the widget
     Widget          *mParent{nullptr};                      ///< The parent widget
     bool            mEnabled{true};                         ///< The enabled state of the widget 
-    Rect            mRect{};                                ///< The rectangle of the widget
+    Rect            mRect{};                                ///< The rectangle of the widget relative to the origin of the parent
     bool            mFilledRect{true};                      ///< The filled rectangle state
     uint32_t        mStyles{0u};                            ///< The style of the widget
     Alignment       mAlignment{Alignment::Left};            ///< The alignment of the widget
@@ -101,6 +130,9 @@ struct Widget {
     uint8_t         *mContent{nullptr};                     ///< The content of the widget
     uint32_t        mIntention{0};                          ///< The interaction intention. 
     CheckBoxContext *mCheckBoxContext{nullptr};             ///< The checkbox context.   
+    uint32_t        mTreeIndex{0};                          ///< The index in the flattened widget tree.
+    LayoutPolicy    mLayoutPolicy{LayoutPolicy::Absolute};  ///< Relative if the rect is computed by the parent container.
+    LayoutNode      *mLayout{nullptr};                      ///< The layout state, nullptr if not used.
 
     // Disable copy and assignment
     Widget(const Widget &) = delete;
@@ -132,6 +164,23 @@ struct Widget {
         return widget;
     }
 
+    /// @brief Will return the screen position the rects of the children are relative to.
+    /// @return The origin, the upper left corner in screen coordinates or (0, 0) for the root.
+    Point2i getOrigin() const {
+        if (mParent == nullptr) {
+            return Point2i(0, 0);
+        }
+        const Point2i origin = mParent->getOrigin();
+        return Point2i(origin.x + mRect.top.x, origin.y + mRect.top.y);
+    }
+
+    /// @brief Will return the rectangle of the widget in screen coordinates.
+    /// @return The screen rectangle.
+    Rect getScreenRect() const {
+        const Point2i origin = mParent != nullptr ? mParent->getOrigin() : Point2i(0, 0);
+        return Rect(origin.x + mRect.top.x, origin.y + mRect.top.y, mRect.width, mRect.height);
+    }
+
     /// @brief Check if the widget has a specific style.
     /// @param[in] style The style to check.
     /// @return true if the widget has the style, false if not.
@@ -162,6 +211,165 @@ struct Widget {
     }
 };
 
+/// @brief The allocator for all widgets of a context.
+struct WidgetPool {
+    ObjectPool<Widget>          mWidgets;       ///< The widget nodes.
+    ObjectPool<CheckBoxContext> mCheckBoxes;    ///< The checkbox states.
+    ObjectPool<LayoutNode>      mLayouts;       ///< The layout states.
+};
+
+/// @brief A uniform grid over the widget rectangles to speed up the hit tests.
+///
+/// Each cell stores the indices of all widgets overlapping it, sorted by the pre-order index.
+/// Widgets covering too many cells or lying outside of the grid are stored in an extra list,
+/// which will be checked for every query.
+struct WidgetGrid {
+    static constexpr int32_t MinCellSize       = 16;    ///< The minimal cell size in pixels.
+    static constexpr int32_t MaxCellsPerAxis   = 128;   ///< The maximal number of cells per axis.
+    static constexpr int32_t MaxCellsPerWidget = 64;    ///< The maximal number of cells for one widget.
+
+    /// @brief Will build the grid.
+    /// @param[in] rects The rectangles of all widgets in pre-order.
+    void build(const std::vector<Rect> &rects);
+
+    /// @brief Will move a widget to its new cells.
+    /// @param[in] index   The index of the widget.
+    /// @param[in] oldRect The old rectangle.
+    /// @param[in] newRect The new rectangle.
+    void update(uint32_t index, const Rect &oldRect, const Rect &newRect);
+
+    /// @brief Will return the cell containing the given position.
+    /// @param[in] x The x-coordinate.
+    /// @param[in] y The y-coordinate.
+    /// @return The widget indices of the cell or nullptr if outside of the grid.
+    const std::vector<uint32_t> *getCell(int32_t x, int32_t y) const;
+
+    /// @brief Will return the widgets, which are not stored in the cells.
+    /// @return The widget indices.
+    const std::vector<uint32_t> &getLargeWidgets() const {
+        return mLarge;
+    }
+
+private:
+    bool getCellRange(const Rect &r, int32_t &x0, int32_t &y0, int32_t &x1, int32_t &y1) const;
+    void insert(uint32_t index, const Rect &r);
+    void remove(uint32_t index, const Rect &r);
+
+private:
+    Vec2i                              mOrigin{};       ///< The upper left corner of the grid.
+    int32_t                            mCellSize{MinCellSize}; ///< The cell size in pixels.
+    int32_t                            mCols{0};        ///< The number of columns.
+    int32_t                            mRows{0};        ///< The number of rows.
+    std::vector<std::vector<uint32_t>> mCells;          ///< The cells.
+    std::vector<uint32_t>              mLarge;          ///< The widgets not stored in the cells.
+};
+
+/// @brief The flattened widget tree.
+///
+/// The hot data of all widgets is stored in parallel arrays in pre-order, so render and hit-test
+/// passes can stream linearly through memory. The cold data like texts, images and callbacks stays
+/// in the widget itself. The tree gets rebuilt lazily after structural changes.
+///
+/// The rects are relative to the parent, so moving a widget only touches the widget itself. The
+/// screen positions are computed by the traversals. The grid stores screen rects, a moved subtree
+/// keeps its old grid entries until it has settled, the hit tests resolve it with the local rects.
+struct WidgetTree {
+    static constexpr uint8_t EnabledFlag = 1;   ///< The widget is enabled.
+    static constexpr uint8_t FilledFlag  = 2;   ///< The widget rectangle is filled.
+    static constexpr uint8_t ClipFlag    = 4;   ///< The children are clipped against the widget rectangle.
+    static constexpr size_t  MaxMovedSubtrees = 32; ///< The grid is rebuilt if more subtrees are moved.
+
+    /// @brief A subtree, which was moved after its grid entries were written.
+    struct MovedSubtree {
+        uint32_t mIndex{0};     ///< The index of the subtree root.
+        uint64_t mFrame{0};     ///< The frame of the last move.
+        bool     mRigid{true};  ///< true if only the root was moved, the grid entries can be translated.
+    };
+
+    std::vector<Rect>       mRects;             ///< The rectangles relative to the origin of the parent.
+    std::vector<Rect>       mBounds;            ///< The bounding box of each subtree relative to the origin of the parent.
+    std::vector<uint8_t>    mFlags;             ///< The state flags.
+    std::vector<WidgetType> mTypes;             ///< The widget types.
+    std::vector<int32_t>    mParents;           ///< The index of the parent, -1 for the root.
+    std::vector<uint32_t>   mSubtreeEnd;        ///< The index behind the last descendant.
+    std::vector<Widget*>    mWidgets;           ///< The widgets with the cold data.
+    std::vector<Rect>       mGridRects;         ///< The screen rects stored in the grid.
+    std::vector<MovedSubtree> mMoved;           ///< The moved subtrees, which are not up to date in the grid.
+    WidgetGrid              mGrid;              ///< The spatial index for the hit tests.
+    uint64_t                mFrame{0};          ///< The frame of the last settle call.
+    bool                    mValid{false};      ///< false if the tree needs to be rebuilt.
+    bool                    mBoundsValid{false};    ///< false if the subtree bounds need to be updated.
+    bool                    mGridValid{false};  ///< false if the grid needs to be rebuilt.
+
+    /// @brief Will rebuild the tree.
+    /// @param[in] root The root widget.
+    void rebuild(Widget *root);
+
+    /// @brief Will update the hot data of one widget, if the tree is valid.
+    /// @param[in] widget The changed widget.
+    void sync(const Widget *widget);
+
+    /// @brief Will update the cached subtree bounds after widgets were resized.
+    void updateBounds();
+
+    /// @brief Will write the subtrees, which were not moved during the last frame, back into the grid.
+    /// @param[in] frame The current frame.
+    void settle(uint64_t frame);
+
+    /// @brief Will return the screen position the rects of the children of a widget are relative to.
+    /// @param[in] index The index of the widget.
+    /// @return The origin, (0, 0) for the root.
+    Point2i getOrigin(uint32_t index) const;
+
+    /// @brief Will return the screen rect of a widget.
+    /// @param[in] index The index of the widget.
+    /// @return The screen rect.
+    Rect getScreenRect(uint32_t index) const;
+
+    /// @brief Will return the screen bounding box of a subtree, the bounds must be valid.
+    /// @param[in] index The index of the subtree root.
+    /// @return The screen bounding box.
+    Rect getScreenBounds(uint32_t index) const;
+
+    /// @brief Will return the index of the topmost enabled widget at the given position.
+    /// @param[in] x The x-coordinate.
+    /// @param[in] y The y-coordinate.
+    /// @return The index or -1 if no widget was hit.
+    int32_t findAt(int32_t x, int32_t y) const;
+
+    /// @brief Will mark the tree for a rebuild.
+    void invalidate() {
+        mValid = false;
+    }
+
+    /// @brief Will check if the widget is stored in the valid tree.
+    /// @param[in] widget The widget to check.
+    /// @return true if the widget is part of the tree.
+    bool contains(const Widget *widget) const {
+        return mValid && widget->mTreeIndex < mWidgets.size() && mWidgets[widget->mTreeIndex] == widget;
+    }
+
+    /// @brief Will return the number of widgets in the tree.
+    /// @return The number of widgets.
+    size_t size() const {
+        return mWidgets.size();
+    }
+
+private:
+    void add(Widget *widget, int32_t parent);
+    void markMoved(uint32_t index, bool positionOnly);
+    void growBounds(uint32_t index);
+    void rebuildGrid();
+    void updateGrid(uint32_t index);
+    bool isMoved(uint32_t index) const;
+    bool isHit(uint32_t index, int32_t x, int32_t y) const;
+    int32_t findInGrid(int32_t x, int32_t y, int32_t dx, int32_t dy, uint32_t first, uint32_t end) const;
+    int32_t findInSubtree(uint32_t index, int32_t x, int32_t y) const;
+
+private:
+    mutable std::vector<Point2i> mOrigins;      ///< The scratch buffer for the origins of the traversals.
+};
+
 /// @brief The widgets access interface.
 ///
 /// This class is used to create and manage widgets.
@@ -200,6 +408,10 @@ struct Widgets {
     /// @return The found widget or nullptr if not found.
     static Widget *findWidget(WidgetHandle id, Widget *root);
 
+    /// @brief Will return the flattened widget tree, it will be rebuilt if required.
+    /// @return The widget tree or nullptr if there are no widgets.
+    static const WidgetTree *getWidgetTree();
+
     /// @brief Will look for a widget by its id.
     /// @param[in]  x            The x-coordinate of the point.
     /// @param[in]  y            The y-coordinate of the point.
@@ -282,6 +494,19 @@ struct Widgets {
     static WidgetHandle checkBox(WidgetHandle parentId, const char *text, const Rect &rect, bool checked, 
         CallbackI *callback);
 
+    /// @brief Creates the overlay showing the render statistics of the last frame.
+    ///
+    /// Only one overlay is supported, a new one replaces the previous one. The overlay gets
+    /// refreshed after every frame, which changed the statistics.
+    /// @param[in] parentId     The parent id of the widget.
+    /// @param[in] rect         The rect of the widget.
+    /// @return The widget handle, InvalidId if the widget was not created.
+    static WidgetHandle statsOverlay(WidgetHandle parentId, const Rect &rect);
+
+    /// @brief Will update the text of the statistics overlay, called after each frame.
+    /// @param[in] damage   The area redrawn by the finished frame.
+    static void updateStatsOverlay(const DirtyRegion &damage);
+
     /// @brief Will render all widgets.
     static void renderWidgets();
 
@@ -293,6 +518,11 @@ struct Widgets {
     static void onMouseButton(int x, int y, int eventType, MouseState state);
 
     /// @brief The on-mouse-move event handler.
+    ///
+    /// The hovered widget is cached, MouseHoverEvent and MouseLeaveEvent will be fired when the
+    /// mouse enters or leaves a widget. The widget callbacks are only called for these transitions,
+    /// the move itself is only posted to the global listeners of the event bus. The backend calls
+    /// it once per update with the last position.
     /// @param[in] x            The x-coordinate of the mouse.
     /// @param[in] y            The y-coordinate of the mouse.
     /// @param[in] eventType    The event type.
@@ -309,10 +539,51 @@ struct Widgets {
 
     /// @brief Will clear a widget by its id.
     /// @param[in] id        The id of the widget to clear.
-    /// @param[in] recursive If true, all child widgets will also be cleared.
+    /// @param[in] recursive If true, all child widgets will be cleared one by one. If false, they are
+    ///                      released together with the widget, because they are not reachable anymore.
     /// @return true if the widget was cleared, false if not.
     static bool clearItem(WidgetHandle id, bool recursive);
     
+    /// @brief Will set the text of a widget.
+    /// @param[in] id   The id of the widget.
+    /// @param[in] text The new text, nullptr will clear the text.
+    /// @return ResultOk if the text was set, InvalidHandle if the widget was not found.
+    static ret_code setText(WidgetHandle id, const char *text);
+
+    /// @brief Will set the rectangle of a widget, the children keep their relative position.
+    /// @param[in] id   The id of the widget.
+    /// @param[in] rect The new rectangle relative to the parent, like the position of setPosition.
+    /// @return ResultOk if the rectangle was set, InvalidHandle if the widget was not found.
+    static ret_code setRect(WidgetHandle id, const Rect &rect);
+
+    /// @brief Will add a style to a widget.
+    /// @param[in] id    The widget id.
+    /// @param[in] style The style to add.
+    /// @return ResultOk if successful, InvalidHandle if the widget is unknown.
+    static ret_code setStyle(WidgetHandle id, WidgetStyle style);
+
+    /// @brief Will move a widget, all children will follow.
+    ///
+    /// Only the widget itself is updated, the rects of the children are relative to it.
+    /// @param[in] id   The widget id.
+    /// @param[in] x    The x-coordinate relative to the parent.
+    /// @param[in] y    The y-coordinate relative to the parent.
+    /// @return ResultOk if successful, InvalidHandle if the widget is unknown.
+    static ret_code setPosition(WidgetHandle id, int32_t x, int32_t y);
+
+    /// @brief Will set the fill rate of a progress bar.
+    /// @param[in] id       The id of the progress bar.
+    /// @param[in] fillRate The fill rate in percent (0-100).
+    /// @return ResultOk if the value was set, ErrorCode if the widget is not a progress bar.
+    static ret_code setProgressValue(WidgetHandle id, int fillRate);
+
+    /// @brief Will mark a widget and its children to be redrawn in the next frame.
+    ///
+    /// Use this after changing widget data directly, all widget setters will do this for you.
+    /// @param[in] id   The id of the widget.
+    /// @return ResultOk if the widget was marked, InvalidHandle if the widget was not found.
+    static ret_code invalidate(WidgetHandle id);
+
     /// @brief The widget enabler
     /// @param[in] id       The id of the widget to enable.
     /// @param[in] enabled  The enabled state of the widget.